@@ -0,0 +1,1436 @@
+
+// bench.cpp: Headless frame-stepping benchmark
+// (Runs the per-frame game pipeline against a null GL backend with the frame limiter off, then
+//  writes per-stage timings + frames/sec as JSON. Builds on Linux with no display: see bench.sh)
+
+// INCLUDES / DEFINES
+
+#include <time.h> // (clock_gettime)
+#include <pthread.h>
+#include <semaphore.h>
+#include <unistd.h> // (sysconf, pread)
+#include <fcntl.h> // (open, posix_fadvise)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#define EGL_NO_X11 // (No X11 types in eglplatform.h: the context is displayless)
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include "game.h"
+#include "null_gl.h"
+#include "egl_gl.h"
+
+// (-gl egl draws into a pbuffer the size of the game's window)
+#define BENCH_GL_WIDTH 1280
+#define BENCH_GL_HEIGHT 720
+
+// PLATFORM SERVICES (Headless)
+
+global_variable bool32 GlobalBenchVerbose = false;
+global_variable bool32 GlobalBenchRealGL = false; // (-gl egl)
+
+internal void PlatformOutputDebugString(char* Message){
+  if(GlobalBenchVerbose){ fputs(Message, stderr); }
+}
+
+internal void* PlatformAllocateMemory(size_t Size){
+  // (Zeroed, to match VirtualAlloc)
+  return calloc(1, Size);
+}
+
+internal void PlatformFreeMemory(void* Memory){
+  free(Memory);
+}
+
+internal ProcessedFile PlatformReadEntireFile(char* Filename){
+  ProcessedFile Result = {};
+  FILE* File = fopen(Filename, "rb");
+  if(File){
+    fseek(File, 0, SEEK_END);
+    long FileSize = ftell(File);
+    fseek(File, 0, SEEK_SET);
+    if(FileSize > 0){
+      Result.Contents = PlatformAllocateMemory(FileSize);
+      if(Result.Contents){
+	if(fread(Result.Contents, 1, FileSize, File) == (size_t)FileSize){
+	  Result.ContentsSize = (uint32)FileSize;
+	}
+	else{
+	  PlatformFreeMemory(Result.Contents);
+	  Result.Contents = 0;
+	}
+      }
+    }
+    fclose(File);
+  }
+  return Result;
+}
+
+internal mapped_file PlatformMapFile(char* Filename){
+  mapped_file Result = {};
+  int File = open(Filename, O_RDONLY);
+  if(File >= 0){
+    struct stat Stat;
+    if(fstat(File, &Stat) == 0 && Stat.st_size > 0){
+      // (MAP_PRIVATE: writes go to private pages, never to the file)
+      void* Memory = mmap(0, Stat.st_size, PROT_READ|PROT_WRITE, MAP_PRIVATE, File, 0);
+      if(Memory != MAP_FAILED){
+	Result.Memory = Memory;
+	Result.Size = (uint64)Stat.st_size;
+      }
+    }
+    close(File); // (The mapping keeps the file alive)
+  }
+  return Result;
+}
+
+internal void PlatformUnmapFile(mapped_file* File){
+  if(File->Memory){ munmap(File->Memory, File->Size); }
+  File->Memory = 0;
+  File->Size = 0;
+}
+
+// (Handle = descriptor + 1, so a valid one is never 0)
+internal void* PlatformOpenFileForReading(char* Filename){
+  int File = open(Filename, O_RDONLY);
+  return (File >= 0) ? (void*)(intptr_t)(File + 1) : 0;
+}
+
+internal bool32 PlatformReadFileAt(void* File, uint64 Offset, void* Dest, uint32 Size){
+  int Descriptor = (int)(intptr_t)File - 1;
+  uint8* At = (uint8*)Dest;
+  while(Size){
+    ssize_t Read = pread(Descriptor, At, Size, (off_t)Offset);
+    if(Read <= 0){ return false; }
+    At += Read;
+    Offset += Read;
+    Size -= (uint32)Read;
+  }
+  return true;
+}
+
+internal void PlatformCloseFile(void* File){
+  if(File){ close((int)(intptr_t)File - 1); }
+}
+
+struct bench_thread_start{
+  platform_thread_proc* Proc;
+  void* Data;
+};
+
+internal void* BenchThreadProc(void* Parameter){
+  bench_thread_start Start = *(bench_thread_start*)Parameter;
+  PlatformFreeMemory(Parameter);
+  Start.Proc(Start.Data);
+  return 0;
+}
+
+internal void* PlatformCreateThread(platform_thread_proc* Proc, void* Data){
+  bench_thread_start* Start = (bench_thread_start*)PlatformAllocateMemory(sizeof(bench_thread_start));
+  Start->Proc = Proc;
+  Start->Data = Data;
+  pthread_t* Thread = (pthread_t*)PlatformAllocateMemory(sizeof(pthread_t));
+  pthread_create(Thread, 0, BenchThreadProc, Start);
+  return Thread;
+}
+
+internal void PlatformJoinThread(void* Thread){
+  pthread_join(*(pthread_t*)Thread, 0);
+  PlatformFreeMemory(Thread);
+}
+
+internal void* PlatformCreateSemaphore(uint32 MaxCount){
+  sem_t* Semaphore = (sem_t*)PlatformAllocateMemory(sizeof(sem_t));
+  sem_init(Semaphore, 0, 0);
+  return Semaphore;
+}
+
+internal void PlatformDestroySemaphore(void* Semaphore){
+  sem_destroy((sem_t*)Semaphore);
+  PlatformFreeMemory(Semaphore);
+}
+
+internal void PlatformSignalSemaphore(void* Semaphore, uint32 Count){
+  for(uint32 i = 0; i < Count; ++i){ sem_post((sem_t*)Semaphore); }
+}
+
+internal void PlatformWaitSemaphore(void* Semaphore){
+  while(sem_wait((sem_t*)Semaphore) != 0){} // (EINTR: retry)
+}
+
+internal uint32 PlatformGetCoreCount(){
+  long Count = sysconf(_SC_NPROCESSORS_ONLN);
+  return (Count > 0) ? (uint32)Count : 1;
+}
+
+// TIMING
+
+internal uint64 BenchGetWallClockNS(){
+  timespec Time;
+  clock_gettime(CLOCK_MONOTONIC, &Time);
+  return ((uint64)Time.tv_sec * 1000000000ull) + (uint64)Time.tv_nsec;
+}
+
+internal real64 PlatformGetWallClockSeconds(){
+  return (real64)BenchGetWallClockNS() * 1e-9;
+}
+
+internal real64 PlatformGetThreadCPUSeconds(){
+  timespec Time;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &Time);
+  return (real64)Time.tv_sec + ((real64)Time.tv_nsec * 1e-9);
+}
+
+internal void PlatformTimerWait(real64 Seconds){
+  timespec Duration;
+  Duration.tv_sec = (time_t)Seconds;
+  Duration.tv_nsec = (long)((Seconds - (real64)Duration.tv_sec) * 1e9);
+  clock_nanosleep(CLOCK_MONOTONIC, 0, &Duration, 0);
+}
+
+// (rdtsc ticks per second, measured against CLOCK_MONOTONIC)
+internal real64 BenchEstimateCPUTimerFrequency(){
+  uint64 StartNS = BenchGetWallClockNS();
+  uint64 StartCycles = ReadCPUTimer();
+  uint64 EndNS;
+  do{
+    EndNS = BenchGetWallClockNS();
+  } while((EndNS - StartNS) < 50000000ull);
+  uint64 EndCycles = ReadCPUTimer();
+
+  return (real64)(EndCycles - StartCycles) * 1e9 / (real64)(EndNS - StartNS);
+}
+
+// (GPU side of a timed section under -gl egl, two ways: GL_TIME_ELAPSED, and the wall time from the first
+//  command to glFinish returning, the pipeline drained beforehand. Drivers that defer rasterization to a flush
+//  (Mesa's llvmpipe) close the query before the fragments run: only the drained time holds them there)
+// (Under the null backend both stay 0: reported as null)
+struct bench_gpu_timer{
+  GLuint Query;
+  uint64 StartNS;
+  uint64 QueryNS;
+  uint64 DrainedNS;
+};
+
+internal void BeginGPUSection(bench_gpu_timer* Timer){
+  if(!Timer->Query){ glGenQueries(1, &Timer->Query); }
+  if(GlobalBenchRealGL){ glFinish(); }
+  Timer->StartNS = BenchGetWallClockNS();
+  glBeginQuery(GL_TIME_ELAPSED, Timer->Query);
+}
+
+internal void EndGPUSection(bench_gpu_timer* Timer){
+  glEndQuery(GL_TIME_ELAPSED);
+  if(!GlobalBenchRealGL){ return; }
+  glFinish();
+  Timer->DrainedNS += BenchGetWallClockNS() - Timer->StartNS;
+  GLuint64 ElapsedNS = 0;
+  glGetQueryObjectui64v(Timer->Query, GL_QUERY_RESULT, &ElapsedNS);
+  Timer->QueryNS += ElapsedNS;
+}
+
+// (Per-frame means as JSON fields, no trailing separator)
+internal void WriteGPUTimes(FILE* Out, bench_gpu_timer* Timer, uint32 Frames){
+  if(GlobalBenchRealGL){
+    fprintf(Out, "\"gpu_us_per_frame\": %.3f, \"drained_us_per_frame\": %.3f",
+	    ((real64)Timer->QueryNS / 1e3) / Frames, ((real64)Timer->DrainedNS / 1e3) / Frames);
+  }
+  else{ fprintf(Out, "\"gpu_us_per_frame\": null, \"drained_us_per_frame\": null"); }
+}
+
+// (Sim stages, then render stages: with -pipeline the render ones run on the render thread, each stage is
+//  only ever recorded from one thread)
+enum bench_stage_id{
+  BenchStage_LoadInternalMap,
+  BenchStage_ProcessGameInput,
+  BenchStage_RainUpdate,
+  BenchStage_PublishFrame,
+  BenchStage_LightUniforms,
+  BenchStage_BaseTextures,
+  BenchStage_RainDraw,
+
+  BenchStage_Count
+};
+
+struct bench_stage{
+  char* Name;
+  uint64 TotalNS;
+  uint64 MinNS;
+  uint64 MaxNS;
+  uint64 Hits;
+};
+global_variable bench_stage GlobalBenchStages[BenchStage_Count] = {
+  {"LoadInternalMap"},
+  {"ProcessGameInput"},
+  {"RainUpdate"},
+  {"PublishFrame"},
+  {"LightUniforms"},
+  {"BaseTextures"},
+  {"RainDraw"},
+};
+
+internal void BenchRecordStage(bench_stage_id ID, uint64 StartNS, uint64 EndNS){
+  bench_stage* Stage = &GlobalBenchStages[ID];
+  uint64 ElapsedNS = EndNS - StartNS;
+  Stage->Hits++;
+  Stage->TotalNS += ElapsedNS;
+  if(Stage->MinNS == 0 || ElapsedNS < Stage->MinNS){ Stage->MinNS = ElapsedNS; }
+  if(ElapsedNS > Stage->MaxNS){ Stage->MaxNS = ElapsedNS; }
+}
+
+// SCRIPTED INPUT
+
+// (One step: hold the given keys for FrameCount frames)
+struct bench_input_step{
+  int32 FrameCount;
+  bool32 Left;
+  bool32 Right;
+};
+struct bench_input_script{
+  static const int32 MAX_STEPS = 256;
+  bench_input_step Steps[MAX_STEPS];
+  int32 StepCount;
+  int32 TotalFrames; // (Frames in one pass of the script; the script loops)
+};
+
+internal void AddInputStep(bench_input_script* Script, int32 FrameCount, bool32 Left, bool32 Right){
+  if(Script->StepCount >= bench_input_script::MAX_STEPS || FrameCount <= 0){ return; }
+  bench_input_step* Step = &Script->Steps[Script->StepCount++];
+  Step->FrameCount = FrameCount;
+  Step->Left = Left;
+  Step->Right = Right;
+  Script->TotalFrames += FrameCount;
+}
+
+// (Default walk: cross the whole map to the right, stand, walk back, mash both keys)
+internal void DefaultInputScript(bench_input_script* Script){
+  *Script = {};
+  AddInputStep(Script, 420, false, true);
+  AddInputStep(Script, 30, false, false);
+  AddInputStep(Script, 420, true, false);
+  AddInputStep(Script, 10, true, true);
+}
+
+// (Script file: one "<keys> <frames>" step per line, keys = idle | left | right | both; '#' comments)
+internal bool32 LoadInputScript(bench_input_script* Script, char* Filename){
+  FILE* File = fopen(Filename, "r");
+  if(!File){ return false; }
+
+  *Script = {};
+  char Line[256];
+  while(fgets(Line, sizeof(Line), File)){
+    char Keys[32];
+    int32 FrameCount;
+    if(Line[0] == '#' || sscanf(Line, "%31s %d", Keys, &FrameCount) != 2){ continue; }
+
+    if(strcmp(Keys, "idle") == 0){ AddInputStep(Script, FrameCount, false, false); }
+    else if(strcmp(Keys, "left") == 0){ AddInputStep(Script, FrameCount, true, false); }
+    else if(strcmp(Keys, "right") == 0){ AddInputStep(Script, FrameCount, false, true); }
+    else if(strcmp(Keys, "both") == 0){ AddInputStep(Script, FrameCount, true, true); }
+  }
+  fclose(File);
+
+  return Script->TotalFrames > 0;
+}
+
+// (Stands in for Win64ProcessKeyboardInput)
+internal void BenchSampleInput(bench_input_script* Script, int32 Frame, game_input* NewInput){
+  int32 ScriptFrame = Frame % Script->TotalFrames;
+  for(int i = 0; i < Script->StepCount; ++i){
+    if(ScriptFrame < Script->Steps[i].FrameCount){
+      NewInput->Left.EndedDown = Script->Steps[i].Left;
+      NewInput->Right.EndedDown = Script->Steps[i].Right;
+      return;
+    }
+    ScriptFrame -= Script->Steps[i].FrameCount;
+  }
+}
+
+// REPORT
+
+// (-pipeline: render stages on a second thread, as in the game)
+struct bench_render_thread{
+  volatile int32 Quit;
+  void* Thread;
+  uint64 RenderedFrames;
+};
+global_variable bench_render_thread GlobalBenchRenderThread;
+
+internal void BenchRenderFrame(render_frame* Frame, real32 Blend){
+  ProfileBeginFrame(ProfileRing_Render);
+  uint64 StageStartNS = BenchGetWallClockNS();
+  GlobalGLRenderer.BaseShader->Use();
+  GlobalLightingSystem.UploadLightBlock(&Frame->Lights, Frame->LightTiles, Frame->LightTileCount, Frame->LightVersion);
+  uint64 StageEndNS = BenchGetWallClockNS();
+  BenchRecordStage(BenchStage_LightUniforms, StageStartNS, StageEndNS);
+
+  StageStartNS = StageEndNS;
+  BindBaseTextures(Frame, Blend);
+  StageEndNS = BenchGetWallClockNS();
+  BenchRecordStage(BenchStage_BaseTextures, StageStartNS, StageEndNS);
+
+  StageStartNS = StageEndNS;
+  GlobalRainSystem.Draw(&Frame->Rain, Blend, Frame->Draws > 0);
+  StageEndNS = BenchGetWallClockNS();
+  BenchRecordStage(BenchStage_RainDraw, StageStartNS, StageEndNS);
+  Frame->Draws++;
+  GlobalBenchRenderThread.RenderedFrames++;
+  ProfileEndFrame(ProfileRing_Render);
+}
+
+internal void BenchRenderThreadProc(void* Data){
+  bench_render_thread* RenderThread = (bench_render_thread*)Data;
+  while(!RenderThread->Quit){
+    PlatformWaitSemaphore(GlobalFrameQueue.PublishSemaphore);
+    render_frame* Frame = AcquireRenderFrame(&GlobalFrameQueue);
+    if(Frame){ BenchRenderFrame(Frame, 1.0f); } // (No wall clock to pace or blend by: newest state as-is)
+  }
+}
+
+internal void WriteBenchReport(FILE* Out, int32 FrameCount, uint64 TotalNS, const char* ScriptName, uint32 Seed){
+  real64 TotalSeconds = (real64)TotalNS / 1e9;
+
+  fprintf(Out, "{\n");
+  fprintf(Out, "  \"frames\": %d,\n", FrameCount);
+  fprintf(Out, "  \"seed\": %u,\n", Seed);
+  fprintf(Out, "  \"script\": \"%s\",\n", ScriptName);
+  fprintf(Out, "  \"render\": \"%s\",\n", (GlobalGLRenderer.Mode == RenderMode_GPUScroll) ? "gpu" : "cpu");
+  fprintf(Out, "  \"normals\": \"%s\",\n", NormalDecodeNames[GlobalGameMap.NormalDecode]);
+  const char* RainModeNames[RainSim_Count] = { "cpu", "stateless", "feedback" };
+  uint32 RainDropCounts[RainSim_Count] = { GlobalRainSystem.ActiveCount, GlobalRainSystem.StatelessCount, GlobalRainSystem.FeedbackCount };
+  fprintf(Out, "  \"rain\": \"%s\",\n", RainModeNames[GlobalRainSystem.Mode]);
+  fprintf(Out, "  \"raindrops\": %u,\n", RainDropCounts[GlobalRainSystem.Mode]);
+  fprintf(Out, "  \"lights\": %d,\n", GlobalLightingSystem.ActiveLightCount);
+  fprintf(Out, "  \"light_emitters\": %d,\n", GlobalGameMap.EmitterCount);
+  fprintf(Out, "  \"scene\": \"%s\",\n", GlobalGameMap.Pack.Memory ? "pack" : "png");
+  fprintf(Out, "  \"job_workers\": %u,\n", GlobalJobSystem.WorkerCount);
+  fprintf(Out, "  \"pipeline\": %s,\n", GlobalBenchRenderThread.Thread ? "true" : "false");
+  fprintf(Out, "  \"sim_hz\": %.1f,\n", GlobalSimHz);
+  fprintf(Out, "  \"render_hz\": %.1f,\n", GlobalRenderHz);
+  fprintf(Out, "  \"rendered_frames\": %llu,\n", (unsigned long long)GlobalBenchRenderThread.RenderedFrames);
+  fprintf(Out, "  \"total_seconds\": %.6f,\n", TotalSeconds);
+  fprintf(Out, "  \"frames_per_second\": %.2f,\n", (real64)FrameCount / TotalSeconds);
+  fprintf(Out, "  \"mean_frame_us\": %.3f,\n", ((real64)TotalNS / 1e3) / FrameCount);
+  fprintf(Out, "  \"gl\": {\"buffer_bytes_per_frame\": %.1f, \"mapped_bytes_per_frame\": %.1f, \"texture_bytes_per_frame\": %.1f, "
+	  "\"uniform_calls_per_frame\": %.1f, \"draw_calls_per_frame\": %.1f},\n",
+	  (real64)GlobalNullGLStats.BufferBytesUploaded / FrameCount,
+	  (real64)GlobalNullGLStats.BufferBytesMapped / FrameCount,
+	  (real64)GlobalNullGLStats.TextureBytesUploaded / FrameCount,
+	  (real64)GlobalNullGLStats.UniformCalls / FrameCount,
+	  (real64)GlobalNullGLStats.DrawCalls / FrameCount);
+  fprintf(Out, "  \"stages\": {\n");
+  for(int i = 0; i < BenchStage_Count; ++i){
+    bench_stage* Stage = &GlobalBenchStages[i];
+    fprintf(Out, "    \"%s\": {\"total_ms\": %.3f, \"mean_us\": %.3f, \"min_us\": %.3f, \"max_us\": %.3f, \"share\": %.4f}%s\n",
+	    Stage->Name,
+	    (real64)Stage->TotalNS / 1e6,
+	    Stage->Hits ? ((real64)Stage->TotalNS / 1e3) / Stage->Hits : 0.0,
+	    (real64)Stage->MinNS / 1e3,
+	    (real64)Stage->MaxNS / 1e3,
+	    (real64)Stage->TotalNS / (real64)TotalNS,
+	    (i == BenchStage_Count - 1) ? "" : ",");
+  }
+  fprintf(Out, "  },\n");
+
+  // (Profiler rings: each ring's TIMED_BLOCKs over its last profile_ring::MAX_FRAMES frames (sim steps /
+  //  render ticks). Called once any render thread has stopped)
+  real64 MicrosecondsPerCycle = 1e6 / GlobalProfiler.CyclesPerSecond;
+  fprintf(Out, "  \"profile\": {\n");
+  for(uint32 RingID = 0; RingID < ProfileRing_Count; ++RingID){
+    fprintf(Out, "    \"%s\": {\n", ProfileRingNames[RingID]);
+    for(uint32 i = 0; i <= ProfileBlock_Count; ++i){
+      if(i < ProfileBlock_Count && ProfileBlockRings[i] != RingID){ continue; }
+      profile_summary Summary = ProfileSummarize((profile_ring_id)RingID, i);
+      fprintf(Out, "      \"%s\": {\"frames\": %u, \"min_us\": %.3f, \"mean_us\": %.3f, \"p99_us\": %.3f, \"max_us\": %.3f, \"hits_per_frame\": %.2f}%s\n",
+	      (i == ProfileBlock_Count) ? "Frame" : ProfileBlockNames[i],
+	      Summary.FrameCount,
+	      Summary.MinCycles * MicrosecondsPerCycle,
+	      Summary.MeanCycles * MicrosecondsPerCycle,
+	      Summary.P99Cycles * MicrosecondsPerCycle,
+	      Summary.MaxCycles * MicrosecondsPerCycle,
+	      Summary.MeanHits,
+	      (i == ProfileBlock_Count) ? "" : ",");
+    }
+    fprintf(Out, "    }%s\n", (RingID == ProfileRing_Count - 1) ? "" : ",");
+  }
+  fprintf(Out, "  }\n");
+  fprintf(Out, "}\n");
+}
+
+// MICROBENCHMARKS
+
+// (The whole map flat, read chunk by chunk from wherever it was loaded from: row-major over Stride =
+//  ChunkCount * WORLD_CHUNK_WIDTH columns, rows in GL order. Reference data, for small scenes only)
+internal int32 BenchReadWholeMap(uint32** Pixels, uint32** Angles){
+  int32 Stride = GlobalGameMap.ChunkCount * WORLD_CHUNK_WIDTH;
+  *Pixels = (uint32*)PlatformAllocateMemory((size_t)Stride * InternalHeight * sizeof(uint32));
+  *Angles = (uint32*)PlatformAllocateMemory((size_t)Stride * InternalHeight * sizeof(uint32));
+  uint32* ChunkPixels = (uint32*)PlatformAllocateMemory(WorldChunkTexels * sizeof(uint32));
+  uint32* ChunkAngles = (uint32*)PlatformAllocateMemory(WorldChunkTexels * sizeof(uint32));
+  for(int32 Chunk = 0; Chunk < GlobalGameMap.ChunkCount; ++Chunk){
+    ReadWorldChunk(&GlobalGameMap, Chunk, ChunkPixels, ChunkAngles);
+    for(int32 Row = 0; Row < (int32)InternalHeight; ++Row){
+      size_t Dest = ((size_t)Row * Stride) + (Chunk * WORLD_CHUNK_WIDTH);
+      memcpy(&(*Pixels)[Dest], &ChunkPixels[Row * WORLD_CHUNK_WIDTH], WORLD_CHUNK_WIDTH * sizeof(uint32));
+      memcpy(&(*Angles)[Dest], &ChunkAngles[Row * WORLD_CHUNK_WIDTH], WORLD_CHUNK_WIDTH * sizeof(uint32));
+    }
+  }
+  PlatformFreeMemory(ChunkPixels);
+  PlatformFreeMemory(ChunkAngles);
+  return Stride;
+}
+
+// (Full-screen map composition: legacy column-major layout (strided reads) vs row-major scanline copies)
+internal void RunComposeBench(FILE* Out, int32 Iterations){
+  // (Rebuild the old column-major, top-down layout from the loaded map)
+  uint32* MapPixels;
+  uint32* MapAngles;
+  int32 Stride = BenchReadWholeMap(&MapPixels, &MapAngles);
+  uint32 MapSize = InternalHeight * GlobalGameMap.Width;
+  uint32* LegacyPixels = (uint32*)PlatformAllocateMemory(MapSize * sizeof(uint32));
+  uint32* LegacyAngles = (uint32*)PlatformAllocateMemory(MapSize * sizeof(uint32));
+  for(int i = 0; i < InternalHeight; ++i){
+    for(int j = 0; j < GlobalGameMap.Width; ++j){
+      LegacyPixels[i + (j * InternalHeight)] = MapPixels[(ScreenRowFromMapRow(i) * Stride) + j];
+      LegacyAngles[i + (j * InternalHeight)] = MapAngles[(ScreenRowFromMapRow(i) * Stride) + j];
+    }
+  }
+  PlatformFreeMemory(MapPixels);
+  PlatformFreeMemory(MapAngles);
+  int32 MaxXOffset = GlobalGameMap.Width - InternalWidth;
+
+  uint64 StartNS = BenchGetWallClockNS();
+  for(int32 Iteration = 0; Iteration < Iterations; ++Iteration){
+    int32 XOffset = Iteration % (MaxXOffset + 1);
+    for(int i = 0; i < InternalHeight; ++i){
+      for(int j = 0; j < InternalWidth; ++j){
+	int SrcIndex = i + ((j + XOffset) * InternalHeight);
+	int DstIndex = OX(ScreenRowFromMapRow(i), j);
+	GlobalGLRenderer.Pixels[DstIndex] = LegacyPixels[SrcIndex];
+	GlobalGLRenderer.Angles[DstIndex] = LegacyAngles[SrcIndex];
+      }
+    }
+  }
+  uint64 ColumnMajorNS = BenchGetWallClockNS() - StartNS;
+
+  int32 SavedXOffset = GlobalGameMap.XOffset;
+  StartNS = BenchGetWallClockNS();
+  for(int32 Iteration = 0; Iteration < Iterations; ++Iteration){
+    GlobalGameMap.XOffset = Iteration % (MaxXOffset + 1);
+    StreamWorldChunks(&GlobalGameMap);
+    CompositeMapRegion(0, InternalHeight, 0, InternalWidth);
+  }
+  uint64 RowMajorNS = BenchGetWallClockNS() - StartNS;
+  GlobalGameMap.XOffset = SavedXOffset;
+
+  real64 BytesPerCompose = 2.0 * InternalWidth * InternalHeight * sizeof(uint32);
+  fprintf(Out, "{\n");
+  fprintf(Out, "  \"mode\": \"compose\",\n");
+  fprintf(Out, "  \"iterations\": %d,\n", Iterations);
+  fprintf(Out, "  \"column_major_us\": %.3f,\n", ((real64)ColumnMajorNS / 1e3) / Iterations);
+  fprintf(Out, "  \"row_major_us\": %.3f,\n", ((real64)RowMajorNS / 1e3) / Iterations);
+  fprintf(Out, "  \"column_major_gb_per_s\": %.3f,\n", (BytesPerCompose * Iterations) / (real64)ColumnMajorNS);
+  fprintf(Out, "  \"row_major_gb_per_s\": %.3f,\n", (BytesPerCompose * Iterations) / (real64)RowMajorNS);
+  fprintf(Out, "  \"speedup\": %.2f\n", (real64)ColumnMajorNS / (real64)RowMajorNS);
+  fprintf(Out, "}\n");
+
+  PlatformFreeMemory(LegacyPixels);
+  PlatformFreeMemory(LegacyAngles);
+}
+
+// (Pre-SoA reference: one struct per drop, sin/cos per drop per frame for both the step and the instance)
+struct bench_aos_raindrop{
+  real32 PosX, PosY;
+  real32 Angle, Velocity;
+  real32 Size;
+  bool32 Active;
+};
+
+internal void BenchResetAoSDrop(bench_aos_raindrop* Drop){
+  real32 x = (real32)(rand() % (InternalHeight + InternalWidth + 20));
+  Drop->PosX = x > (InternalWidth + 10) ? (InternalWidth + 10) : x;
+  Drop->PosY = x > (InternalWidth + 10) ?  x - (InternalWidth + 10) : (InternalHeight + 10);
+  Drop->Angle = 3.5f;
+  Drop->Velocity = 4.5f + (2.0f * ((real32)rand() / RAND_MAX));
+  Drop->Size = 1.0f + ((real32)rand() / RAND_MAX);
+  Drop->Active = true;
+}
+
+internal void BenchStepAoSDrops(bench_aos_raindrop* Drops, uint32 Count, real32* InstanceData){
+  for(uint32 i = 0; i < Count; ++i){
+    bench_aos_raindrop* Drop = &Drops[i];
+    if(!Drop->Active) continue;
+    Drop->PosX += Drop->Velocity * sin(Drop->Angle);
+    Drop->PosY += Drop->Velocity * cos(Drop->Angle);
+    if(Drop->PosY < 0 || Drop->PosX < 0){ BenchResetAoSDrop(Drop); }
+  }
+  for(uint32 i = 0; i < Count; ++i){
+    InstanceData[i * 4] = Drops[i].PosX;
+    InstanceData[i * 4 + 1] = Drops[i].PosY;
+    InstanceData[i * 4 + 2] = Drops[i].Velocity * sin(Drops[i].Angle);
+    InstanceData[i * 4 + 3] = -Drops[i].Velocity * cos(Drops[i].Angle);
+  }
+}
+
+// (Rain kernel throughput: SoA + SSE (RainStepDrops) vs the AoS reference, drops per ns at several counts)
+internal void RunRainBench(FILE* Out){
+  uint32 DropCounts[] = { 1000, 100000, 1000000 };
+  uint64 TargetDropSteps = 50000000; // (Per kernel per count: frames = TargetDropSteps / drops)
+
+  fprintf(Out, "{\n");
+  fprintf(Out, "  \"mode\": \"rain\",\n");
+  fprintf(Out, "  \"kernels\": [\n");
+  for(uint32 CountIndex = 0; CountIndex < ArrayCount(DropCounts); ++CountIndex){
+    uint32 Count = DropCounts[CountIndex];
+    uint32 Frames = (uint32)(TargetDropSteps / Count);
+
+    rain_drops Drops;
+    Drops.PosX = (real32*)PlatformAllocateMemory(Count * sizeof(real32));
+    Drops.PosY = (real32*)PlatformAllocateMemory(Count * sizeof(real32));
+    Drops.VelX = (real32*)PlatformAllocateMemory(Count * sizeof(real32));
+    Drops.VelY = (real32*)PlatformAllocateMemory(Count * sizeof(real32));
+    Drops.Size = (real32*)PlatformAllocateMemory(Count * sizeof(real32));
+    bench_aos_raindrop* AoSDrops = (bench_aos_raindrop*)PlatformAllocateMemory(Count * sizeof(bench_aos_raindrop));
+    real32* InstanceData = (real32*)PlatformAllocateMemory(Count * 4 * sizeof(real32));
+    random_series Series = RandomSeed(Count);
+    RainInitDrops(&Drops, Count, &Series);
+    for(uint32 i = 0; i < Count; ++i){
+      BenchResetAoSDrop(&AoSDrops[i]);
+    }
+
+    uint64 StartNS = BenchGetWallClockNS();
+    for(uint32 Frame = 0; Frame < Frames; ++Frame){ RainStepDrops(&Drops, Count, InstanceData, &Series); }
+    uint64 SoANS = BenchGetWallClockNS() - StartNS;
+
+    StartNS = BenchGetWallClockNS();
+    for(uint32 Frame = 0; Frame < Frames; ++Frame){ BenchStepAoSDrops(AoSDrops, Count, InstanceData); }
+    uint64 AoSNS = BenchGetWallClockNS() - StartNS;
+
+    real64 DropSteps = (real64)Count * Frames;
+    fprintf(Out, "    {\"drops\": %u, \"frames\": %u, \"soa_simd_drops_per_ns\": %.3f, \"aos_scalar_drops_per_ns\": %.3f, "
+	    "\"soa_simd_us_per_frame\": %.3f, \"aos_scalar_us_per_frame\": %.3f, \"speedup\": %.2f}%s\n",
+	    Count, Frames,
+	    DropSteps / (real64)SoANS, DropSteps / (real64)AoSNS,
+	    ((real64)SoANS / 1e3) / Frames, ((real64)AoSNS / 1e3) / Frames,
+	    (real64)AoSNS / (real64)SoANS,
+	    (CountIndex == ArrayCount(DropCounts) - 1) ? "" : ",");
+
+    PlatformFreeMemory(Drops.PosX);
+    PlatformFreeMemory(Drops.PosY);
+    PlatformFreeMemory(Drops.VelX);
+    PlatformFreeMemory(Drops.VelY);
+    PlatformFreeMemory(Drops.Size);
+    PlatformFreeMemory(AoSDrops);
+    PlatformFreeMemory(InstanceData);
+  }
+  fprintf(Out, "  ]\n");
+  fprintf(Out, "}\n");
+}
+
+// (Rain scaling: per-frame Update + Draw cost for each rain mode, 1k -> 1M drops)
+// (GPU times need -gl egl (BeginGPUSection): null under the null backend)
+internal void RunRainScalingBench(FILE* Out){
+  uint32 DropCounts[] = { 1000, 10000, 100000, 1000000 };
+  const char* ModeNames[RainSim_Count] = { "cpu", "stateless", "feedback" };
+  rain_sim_mode SavedMode = GlobalRainSystem.Mode;
+
+  bench_gpu_timer Timer = {};
+  rain_frame RainFrame = {};
+
+  fprintf(Out, "{\n");
+  fprintf(Out, "  \"mode\": \"rain-scaling\",\n");
+  fprintf(Out, "  \"gl_backend\": \"%s\",\n", GlobalBenchRealGL ? "egl" : "null");
+  fprintf(Out, "  \"runs\": [\n");
+  for(uint32 ModeIndex = 0; ModeIndex < RainSim_Count; ++ModeIndex){
+    for(uint32 CountIndex = 0; CountIndex < ArrayCount(DropCounts); ++CountIndex){
+      uint32 Count = DropCounts[CountIndex];
+      rain_sim_mode Mode = (rain_sim_mode)ModeIndex;
+      if(Mode == RainSim_CPU){ GlobalRainSystem.InitSystem(Count, Count); }
+      else if(Mode == RainSim_Stateless){ GlobalRainSystem.InitStateless(Count); }
+      else{ GlobalRainSystem.InitFeedback(Count); }
+      GlobalRainSystem.Mode = Mode;
+
+      uint32 Frames = 20000000 / Count;
+      if(Frames < 20){ Frames = 20; }
+      // (Each real-GL frame drains the pipeline twice: fewer of them)
+      if(Frames > (GlobalBenchRealGL ? 200u : 2000u)){ Frames = GlobalBenchRealGL ? 200 : 2000; }
+
+      // (Untimed first frame: buffer storage and shader state get set up on first use)
+      GlobalRainSystem.Update(&RainFrame);
+      GlobalRainSystem.Draw(&RainFrame, 1.0f, false);
+
+      uint64 CPUNS = 0;
+      Timer.QueryNS = 0;
+      Timer.DrainedNS = 0;
+      for(uint32 Frame = 0; Frame < Frames; ++Frame){
+	BeginGPUSection(&Timer);
+	uint64 StartNS = BenchGetWallClockNS();
+	GlobalRainSystem.Update(&RainFrame);
+	GlobalRainSystem.Draw(&RainFrame, 1.0f, false);
+	CPUNS += BenchGetWallClockNS() - StartNS;
+	EndGPUSection(&Timer);
+      }
+
+      bool32 Last = (ModeIndex == RainSim_Count - 1) && (CountIndex == ArrayCount(DropCounts) - 1);
+      fprintf(Out, "    {\"rain\": \"%s\", \"drops\": %u, \"frames\": %u, \"cpu_us_per_frame\": %.3f, ",
+	      ModeNames[ModeIndex], Count, Frames, ((real64)CPUNS / 1e3) / Frames);
+      WriteGPUTimes(Out, &Timer, Frames);
+      fprintf(Out, "}%s\n", Last ? "" : ",");
+    }
+  }
+  fprintf(Out, "  ]\n");
+  fprintf(Out, "}\n");
+
+  glDeleteQueries(1, &Timer.Query);
+  if(RainFrame.Instances){ PlatformFreeMemory(RainFrame.Instances); }
+  GlobalRainSystem.Mode = SavedMode;
+}
+
+// (Lighting against the scene's light count: N street lamps scattered over the screen, lit by each light render
+//  mode. CullLightTiles is timed per rebuild; per mode, the base pass' CPU submit time, its GPU times (-gl egl,
+//  see BeginGPUSection: null otherwise) and the light evaluations per screen pixel it shades: tile list lengths
+//  for tiled, each light's clipped quad area for light volumes (the count the GPU times follow))
+// (Run once per normal decode, the scene reloaded with it: the same lights each time, so the decodes differ in
+//  the base pass' times only)
+internal void RunLightsBench(FILE* Out, uint32 Seed){
+  uint32 LightCounts[] = { 8, 32, 64, 128, 256 };
+  uint32* Entries = (uint32*)PlatformAllocateMemory(sizeof(uint32) * lighting_system::MAX_TILE_ENTRIES);
+  real64 ScreenPixels = (real64)InternalWidth * InternalHeight;
+  light_render_mode SavedMode = GlobalLightingSystem.RenderMode;
+  normal_decode SavedDecode = GlobalNormalDecode;
+
+  bench_gpu_timer Timer = {};
+
+  fprintf(Out, "{\n");
+  fprintf(Out, "  \"mode\": \"lights\",\n");
+  fprintf(Out, "  \"gl_backend\": \"%s\",\n", GlobalBenchRealGL ? "egl" : "null");
+  fprintf(Out, "  \"tile_size\": %d,\n", LIGHT_TILE_SIZE);
+  fprintf(Out, "  \"tiles\": %u,\n", LightTileCount);
+  fprintf(Out, "  \"normal_decodes\": {\n");
+  for(uint32 DecodeIndex = 0; DecodeIndex < NormalDecode_Count; ++DecodeIndex){
+    GlobalNormalDecode = (normal_decode)DecodeIndex;
+    LoadGameScene();
+    // (Bring the map's streamed lights up to date first, so BuildRenderFrame below leaves the bench's lights be)
+    StreamMapLights(&GlobalGameMap);
+    fprintf(Out, "    \"%s\": [\n", NormalDecodeNames[DecodeIndex]);
+    for(uint32 CountIndex = 0; CountIndex < ArrayCount(LightCounts); ++CountIndex){
+      uint32 Count = LightCounts[CountIndex];
+      random_series Series = RandomSeed(Seed, Count);
+      GlobalLightingSystem.ClearLights();
+      light_handle Handles[lighting_system::MAX_LIGHTS];
+      real64 VolumePixels = 0.0;
+      for(uint32 i = 0; i < Count; ++i){
+	real32 X = RandomBetween(&Series, 0.0f, (real32)InternalWidth);
+	real32 Y = RandomBetween(&Series, 0.0f, (real32)InternalHeight);
+	real32 Radius = RandomBetween(&Series, 16.0f, 64.0f);
+	Handles[i] = GlobalLightingSystem.AddLight(X, Y, 1.0f, 0.8f, 0.6f, 2.0f, Radius);
+	// (Same clipped rect shader.vert draws)
+	real32 Width = fminf(X + Radius, (real32)InternalWidth) - fmaxf(X - Radius, 0.0f);
+	real32 Height = fminf(Y + Radius, (real32)InternalHeight) - fmaxf(Y - Radius, 0.0f);
+	VolumePixels += (real64)Width * Height;
+      }
+
+      GlobalLightingSystem.UpdateLightBlock();
+
+      uint32 Iterations = 2000;
+      uint32 Used = 0;
+      uint64 StartNS = BenchGetWallClockNS();
+      for(uint32 Iteration = 0; Iteration < Iterations; ++Iteration){
+	Used = CullLightTiles(GlobalLightingSystem.UniformBlock.Lights, Count, Entries);
+      }
+      uint64 CullNS = BenchGetWallClockNS() - StartNS;
+
+      // (Pool churn: remove a random light and add it back (swap-remove + free-slot reuse), as streaming does)
+      StartNS = BenchGetWallClockNS();
+      for(uint32 Iteration = 0; Iteration < Iterations; ++Iteration){
+	uint32 Index = RandomChoice(&Series, Count);
+	light_source Light = *GlobalLightingSystem.GetLight(Handles[Index]);
+	GlobalLightingSystem.RemoveLight(Handles[Index]);
+	Handles[Index] = GlobalLightingSystem.AddLight(Light.PosX, Light.PosY, Light.R, Light.G, Light.B, Light.Intensity, Light.Radius);
+      }
+      uint64 ChurnNS = BenchGetWallClockNS() - StartNS;
+
+      // (Pixels per tile: edge tiles are clipped by the screen)
+      uint64 TiledTests = 0;
+      uint32 MaxPerTile = 0;
+      for(uint32 Tile = 0; Tile < LightTileCount; ++Tile){
+	uint32 TileX = Tile % LightTilesX;
+	uint32 TileY = Tile / LightTilesX;
+	uint32 Width = InternalWidth - (TileX * LIGHT_TILE_SIZE);
+	uint32 Height = InternalHeight - (TileY * LIGHT_TILE_SIZE);
+	if(Width > LIGHT_TILE_SIZE){ Width = LIGHT_TILE_SIZE; }
+	if(Height > LIGHT_TILE_SIZE){ Height = LIGHT_TILE_SIZE; }
+	uint32 TileLights = Entries[(2 * Tile) + 1];
+	TiledTests += (uint64)Width * Height * TileLights;
+	if(TileLights > MaxPerTile){ MaxPerTile = TileLights; }
+      }
+      real64 TestsPerPixel[LightRender_Count] = { (real64)TiledTests / ScreenPixels, VolumePixels / ScreenPixels };
+
+      fprintf(Out, "      {\"lights\": %u, \"cull_us\": %.3f, \"remove_add_ns\": %.1f, \"tile_entries\": %u, \"mean_lights_per_tile\": %.2f, \"max_lights_per_tile\": %u, "
+	      "\"untiled_tests_per_pixel\": %u,\n",
+	      Count, ((real64)CullNS / 1e3) / Iterations, (real64)ChurnNS / Iterations, Used, (real64)(Used - LIGHT_TILE_HEADER) / LightTileCount, MaxPerTile,
+	      Count);
+      for(uint32 ModeIndex = 0; ModeIndex < LightRender_Count; ++ModeIndex){
+	GlobalLightingSystem.RenderMode = (light_render_mode)ModeIndex;
+	BuildRenderFrame(&GlobalFrameQueue, 0.0);
+	render_frame* Frame = SimRenderFrame(&GlobalFrameQueue);
+
+	// (Untimed first draw: the new light block and tile lists upload here. Each real-GL frame drains the
+	//  pipeline twice: fewer of them)
+	RenderBasePass(Frame, 1.0f);
+	Frame->Draws++;
+	uint32 Frames = GlobalBenchRealGL ? 50 : 500;
+	uint64 CPUNS = 0;
+	Timer.QueryNS = 0;
+	Timer.DrainedNS = 0;
+	for(uint32 FrameIndex = 0; FrameIndex < Frames; ++FrameIndex){
+	  BeginGPUSection(&Timer);
+	  StartNS = BenchGetWallClockNS();
+	  RenderBasePass(Frame, 1.0f);
+	  CPUNS += BenchGetWallClockNS() - StartNS;
+	  EndGPUSection(&Timer);
+	  Frame->Draws++;
+	}
+
+	fprintf(Out, "        \"%s\": {\"light_tests_per_pixel\": %.2f, \"cpu_us_per_frame\": %.3f, ",
+		LightRenderModeNames[ModeIndex], TestsPerPixel[ModeIndex], ((real64)CPUNS / 1e3) / Frames);
+	WriteGPUTimes(Out, &Timer, Frames);
+	fprintf(Out, "}%s\n", (ModeIndex == LightRender_Count - 1) ? "" : ",");
+      }
+      fprintf(Out, "      }%s\n", (CountIndex == ArrayCount(LightCounts) - 1) ? "" : ",");
+    }
+    fprintf(Out, "    ]%s\n", (DecodeIndex == NormalDecode_Count - 1) ? "" : ",");
+  }
+  fprintf(Out, "  }\n");
+  fprintf(Out, "}\n");
+
+  glDeleteQueries(1, &Timer.Query);
+  GlobalLightingSystem.RenderMode = SavedMode;
+  GlobalNormalDecode = SavedDecode;
+  PlatformFreeMemory(Entries);
+}
+
+// (Scene cooker: PNGs -> scene pack, in the layout LoadScenePack maps, WorldWidth columns wide (0: the scene's))
+internal int RunCook(FILE* Out, char* PackName, int32 WorldWidth){
+  GlobalNormalDecode = NormalDecode_Load; // (Packs hold load-decoded normals, whatever -normals says)
+  LoadScenePNGs();
+  if(WorldWidth <= 0){ WorldWidth = GlobalGameMap.Width; }
+  if(!WriteScenePack(&GlobalGameMap, &GlobalSpriteMap, WorldWidth, PackName)){
+    fprintf(stderr, "bench: could not write %s\n", PackName);
+    return 1;
+  }
+  struct stat Stat = {};
+  stat(PackName, &Stat);
+  fprintf(Out, "{\n");
+  fprintf(Out, "  \"mode\": \"cook\",\n");
+  fprintf(Out, "  \"pack\": \"%s\",\n", PackName);
+  fprintf(Out, "  \"bytes\": %lld,\n", (long long)Stat.st_size);
+  fprintf(Out, "  \"world_width\": %d,\n", WorldWidth);
+  fprintf(Out, "  \"scene_light_emitters\": %d\n", GlobalGameMap.EmitterCount);
+  fprintf(Out, "}\n");
+  return 0;
+}
+
+// (Scene load timing: PNG decode + repack vs mapping the pack, each up to the first screen's chunks being
+//  resident. Every load runs in a forked child so each starts from the same process state and its peak memory
+//  can be read on its own)
+struct bench_scene_load{
+  real64 Seconds;
+  int64 PeakKB; // (Resident set growth over the load, file-backed pages included)
+  uint64 Checksum;
+  bool32 Loaded;
+};
+
+// (Field of /proc/self/status in kB, -1 if missing)
+internal int64 BenchReadStatusKB(const char* Field){
+  int64 Result = -1;
+  FILE* Status = fopen("/proc/self/status", "r");
+  if(Status){
+    char Line[256];
+    size_t FieldLength = strlen(Field);
+    while(fgets(Line, sizeof(Line), Status)){
+      if(strncmp(Line, Field, FieldLength) == 0){
+	Result = strtoll(Line + FieldLength, 0, 10);
+	break;
+      }
+    }
+    fclose(Status);
+  }
+  return Result;
+}
+
+// (Drop Filename's clean pages from the OS file cache: an approximation of a cold start (a true one also
+//  needs the drive's own cache cold))
+internal void BenchEvictFile(char* Filename){
+  int File = open(Filename, O_RDONLY);
+  if(File >= 0){
+    fdatasync(File);
+    posix_fadvise(File, 0, 0, POSIX_FADV_DONTNEED);
+    close(File);
+  }
+}
+
+internal bench_scene_load BenchMeasureSceneLoad(bool32 FromPack, char* PackName){
+  bench_scene_load Result = {};
+  int Pipe[2];
+  if(pipe(Pipe) != 0){ return Result; }
+  pid_t Child = fork();
+  if(Child == 0){
+    close(Pipe[0]);
+    // (Peak resident set restarts from here ("5" resets VmHWM))
+    FILE* ClearRefs = fopen("/proc/self/clear_refs", "w");
+    if(ClearRefs){ fputs("5", ClearRefs); fclose(ClearRefs); }
+    int64 BaseKB = BenchReadStatusKB("VmRSS:");
+
+    uint64 StartNS = BenchGetWallClockNS();
+    if(FromPack){ Result.Loaded = LoadScenePack(&GlobalGameMap, &GlobalSpriteMap, PackName); }
+    else{ LoadScenePNGs(); Result.Loaded = true; }
+    // (Read everything the resident texture upload would)
+    if(Result.Loaded){
+      GlobalGameMap.XOffset = 0;
+      ResetWorldStreamer(&GlobalGameMap);
+      StreamWorldChunks(&GlobalGameMap);
+      for(int32 Chunk = 0; Chunk < WORLD_RESIDENT_CHUNKS; ++Chunk){
+	world_chunk_slot* Slot = &GlobalWorldStreamer.Slots[Chunk];
+	if(Slot->State != WorldChunk_Ready){ continue; }
+	for(uint32 i = 0; i < WorldChunkTexels; ++i){ Result.Checksum += Slot->Pixels[i] ^ Slot->Angles[i]; }
+      }
+      for(uint32 i = 0; i < SpriteMapWidth * SpriteMapHeight; ++i){ Result.Checksum += GlobalSpriteMap.Pixels[i]; }
+    }
+    Result.Seconds = (real64)(BenchGetWallClockNS() - StartNS) / 1e9;
+    Result.PeakKB = BenchReadStatusKB("VmHWM:") - BaseKB;
+
+    // (Whole map, untimed: the comparison covers what the streamer hasn't read yet too)
+    if(Result.Loaded){
+      Result.Checksum = 0;
+      uint32* MapPixels;
+      uint32* MapAngles;
+      int32 Stride = BenchReadWholeMap(&MapPixels, &MapAngles);
+      for(int32 i = 0; i < Stride * (int32)InternalHeight; ++i){ Result.Checksum += MapPixels[i] ^ MapAngles[i]; }
+      for(uint32 i = 0; i < SpriteMapWidth * SpriteMapHeight; ++i){ Result.Checksum += GlobalSpriteMap.Pixels[i]; }
+    }
+
+    ssize_t Written = write(Pipe[1], &Result, sizeof(Result));
+    _exit(Written == (ssize_t)sizeof(Result) ? 0 : 1);
+  }
+  close(Pipe[1]);
+  if(Child > 0){
+    if(read(Pipe[0], &Result, sizeof(Result)) != (ssize_t)sizeof(Result)){ Result = {}; }
+    waitpid(Child, 0, 0);
+  }
+  close(Pipe[0]);
+  return Result;
+}
+
+internal int RunStartupBench(FILE* Out, char* PackName){
+  char* PNGNames[] = { "../media/Scene1.png", "../media/NormalMap1.png", "../media/Anim1.png" };
+  const char* SourceNames[2] = { "png", "pack" };
+  struct stat Stat = {};
+  if(stat(PackName, &Stat) != 0){
+    fprintf(stderr, "bench: no scene pack at %s (run -mode cook first)\n", PackName);
+    return 1;
+  }
+
+  fprintf(Out, "{\n");
+  fprintf(Out, "  \"mode\": \"startup\",\n");
+  fprintf(Out, "  \"sources\": {\n");
+  bench_scene_load Loads[2][2] = {}; // ([Source][Cold, Warm])
+  for(uint32 Source = 0; Source < 2; ++Source){
+    int64 Bytes = 0;
+    if(Source == 0){
+      for(uint32 i = 0; i < ArrayCount(PNGNames); ++i){
+	BenchEvictFile(PNGNames[i]);
+	if(stat(PNGNames[i], &Stat) == 0){ Bytes += Stat.st_size; }
+      }
+    }
+    else{
+      BenchEvictFile(PackName);
+      stat(PackName, &Stat);
+      Bytes = Stat.st_size;
+    }
+    Loads[Source][0] = BenchMeasureSceneLoad(Source == 1, PackName);
+    Loads[Source][1] = BenchMeasureSceneLoad(Source == 1, PackName);
+    if(!Loads[Source][0].Loaded || !Loads[Source][1].Loaded){
+      fprintf(stderr, "bench: %s scene load failed\n", SourceNames[Source]);
+    }
+
+    fprintf(Out, "    \"%s\": {\"file_bytes\": %lld, \"cold_ms\": %.3f, \"warm_ms\": %.3f, \"cold_peak_kb\": %lld, \"warm_peak_kb\": %lld}%s\n",
+	    SourceNames[Source], (long long)Bytes, Loads[Source][0].Seconds * 1e3, Loads[Source][1].Seconds * 1e3,
+	    (long long)Loads[Source][0].PeakKB, (long long)Loads[Source][1].PeakKB, (Source == 0) ? "," : "");
+  }
+  fprintf(Out, "  },\n");
+  // (Same scene either way, or the pack is stale)
+  fprintf(Out, "  \"same_contents\": %s\n", (Loads[0][1].Checksum == Loads[1][1].Checksum) ? "true" : "false");
+  fprintf(Out, "}\n");
+  return 0;
+}
+
+// (Long walk: the player sprints right across a world cooked wide (-mode cook -world-width N), from a cold
+//  file cache, the map streaming in through world.h. Reports per-step cost, the steps that had to wait on a
+//  chunk (stalls: the hitches streaming is there to prevent) and resident memory over the walk)
+// (StepHz > 0 paces the steps on the wall clock; 0 runs them back to back, which outpaces any drive: stalls
+//  then measure how far the sim can outrun the I/O thread)
+#define BENCH_WALK_SPEED 8 // (Columns per step: a chunk every 16 steps, well past the walking speed)
+internal int RunWalkBench(FILE* Out, char* PackName, real64 StepHz){
+  BenchEvictFile(PackName);
+  if(!LoadScenePack(&GlobalGameMap, &GlobalSpriteMap, PackName)){
+    fprintf(stderr, "bench: no usable scene pack at %s (run -mode cook -world-width N first)\n", PackName);
+    return 1;
+  }
+  GlobalGameMap.XOffset = 0;
+  ResetWorldStreamer(&GlobalGameMap);
+  StreamWorldChunks(&GlobalGameMap);
+  UploadResidentSceneTextures();
+  GlobalCompositor.Valid = false;
+  LoadInternalMap();
+
+  real32 SavedSpeed = GlobalPlayerState.MovementSpeed;
+  GlobalPlayerState.MovementSpeed = (real32)(BENCH_WALK_SPEED * GlobalSimHz);
+  game_input Input[2] = {};
+  Input[0].Right.EndedDown = true;
+  Input[1].Right.EndedDown = true;
+
+  int32 MaxSteps = (GlobalGameMap.Width / BENCH_WALK_SPEED) + 64;
+  uint64* StepNS = (uint64*)PlatformAllocateMemory(sizeof(uint64) * MaxSteps);
+  uint64 LoadedBefore = GlobalWorldStreamer.ChunksLoaded;
+  uint64 StallsBefore = GlobalWorldStreamer.Stalls;
+  int64 StartKB = BenchReadStatusKB("VmRSS:");
+  int64 PeakKB = StartKB;
+  int32 Steps = 0;
+  real64 NextStep = PlatformGetWallClockSeconds();
+  while(Steps < MaxSteps && GlobalGameMap.XOffset < GlobalGameMap.Width - (int32)InternalWidth){
+    if(StepHz > 0.0){
+      real64 Now = PlatformGetWallClockSeconds();
+      if(Now < NextStep){ PlatformTimerWait(NextStep - Now); }
+      NextStep += 1.0 / StepHz;
+    }
+    uint64 StartNS = BenchGetWallClockNS();
+    if(GlobalGLRenderer.Mode == RenderMode_CPUComposite){
+      LoadInternalMap();
+    }
+    ProcessGameInput(&Input[0], &Input[1]);
+    BuildRenderFrame(&GlobalFrameQueue, 0.0);
+    PublishRenderFrame(&GlobalFrameQueue);
+    BenchRenderFrame(AcquireRenderFrame(&GlobalFrameQueue), 1.0f);
+    StepNS[Steps++] = BenchGetWallClockNS() - StartNS;
+    if((Steps % 256) == 0){
+      int64 KB = BenchReadStatusKB("VmRSS:");
+      if(KB > PeakKB){ PeakKB = KB; }
+    }
+  }
+  GlobalPlayerState.MovementSpeed = SavedSpeed;
+
+  uint64 TotalNS = 0;
+  for(int32 i = 0; i < Steps; ++i){ TotalNS += StepNS[i]; }
+  qsort(StepNS, Steps, sizeof(uint64), CompareCycles);
+  uint64 ResidentBytes = (uint64)WORLD_RESIDENT_CHUNKS * 2 * WorldChunkTexels * sizeof(uint32);
+  uint64 FlatBytes = (uint64)GlobalGameMap.Width * InternalHeight * 2 * sizeof(uint32);
+
+  fprintf(Out, "{\n");
+  fprintf(Out, "  \"mode\": \"walk\",\n");
+  fprintf(Out, "  \"pack\": \"%s\",\n", PackName);
+  fprintf(Out, "  \"render\": \"%s\",\n", (GlobalGLRenderer.Mode == RenderMode_GPUScroll) ? "gpu" : "cpu");
+  fprintf(Out, "  \"world_width\": %d,\n", GlobalGameMap.Width);
+  fprintf(Out, "  \"step_hz\": %.1f,\n", StepHz);
+  fprintf(Out, "  \"walked\": %d,\n", GlobalGameMap.XOffset);
+  fprintf(Out, "  \"steps\": %d,\n", Steps);
+  fprintf(Out, "  \"step_us\": {\"mean\": %.3f, \"median\": %.3f, \"p99\": %.3f, \"max\": %.3f},\n",
+	  Steps ? ((real64)TotalNS / 1e3) / Steps : 0.0, Steps ? StepNS[Steps / 2] / 1e3 : 0.0,
+	  Steps ? StepNS[((Steps - 1) * 99) / 100] / 1e3 : 0.0, Steps ? StepNS[Steps - 1] / 1e3 : 0.0);
+  fprintf(Out, "  \"chunks_loaded\": %llu,\n", (unsigned long long)(GlobalWorldStreamer.ChunksLoaded - LoadedBefore));
+  fprintf(Out, "  \"stalls\": %llu,\n", (unsigned long long)(GlobalWorldStreamer.Stalls - StallsBefore));
+  fprintf(Out, "  \"resident_chunk_bytes\": %llu,\n", (unsigned long long)ResidentBytes);
+  fprintf(Out, "  \"whole_map_bytes\": %llu,\n", (unsigned long long)FlatBytes);
+  fprintf(Out, "  \"rss_growth_kb\": %lld\n", (long long)(PeakKB - StartKB));
+  fprintf(Out, "}\n");
+  PlatformFreeMemory(StepNS);
+  return 0;
+}
+
+// (Frame pacer strategies against a wall clock, nothing drawn: interval error percentiles + CPU share per
+//  strategy. Vsync needs a display: reported as skipped)
+internal void RunPacingBench(FILE* Out, uint32 Intervals, real64 TargetHz){
+  fprintf(Out, "{\n");
+  fprintf(Out, "  \"mode\": \"pacing\",\n");
+  fprintf(Out, "  \"target_hz\": %.1f,\n", TargetHz);
+  fprintf(Out, "  \"runs\": [\n");
+  for(uint32 Strategy = 0; Strategy < FramePace_Count; ++Strategy){
+    bool32 Last = (Strategy == FramePace_Count - 1);
+    if(Strategy == FramePace_VSync){
+      fprintf(Out, "    {\"strategy\": \"%s\", \"skipped\": \"no display\"}%s\n", FramePaceStrategyNames[Strategy], Last ? "" : ",");
+      continue;
+    }
+
+    frame_pacer Pacer;
+    FramePacerReset(&Pacer, (frame_pace_strategy)Strategy, TargetHz, PlatformGetWallClockSeconds());
+    FramePacerPresented(&Pacer); // (Interval 0 starts here)
+    for(uint32 Interval = 0; Interval < Intervals; ++Interval){
+      FramePacerWait(&Pacer);
+      FramePacerPresented(&Pacer);
+    }
+    fprintf(Out, "    {\"strategy\": \"%s\", \"intervals\": %llu, \"mean_interval_ms\": %.4f, \"p50_us\": %.0f, \"p99_us\": %.0f, \"p999_us\": %.0f, \"max_us\": %.1f, \"cpu_share\": %.3f}%s\n",
+	    FramePaceStrategyNames[Strategy], (unsigned long long)Pacer.IntervalCount,
+	    (Pacer.IntervalTotal / Pacer.IntervalCount) * 1e3,
+	    FramePacerPercentileUS(&Pacer, 0.5), FramePacerPercentileUS(&Pacer, 0.99), FramePacerPercentileUS(&Pacer, 0.999),
+	    Pacer.MaxError * 1e6, FramePacerCPUShare(&Pacer), Last ? "" : ",");
+  }
+  fprintf(Out, "  ]\n");
+  fprintf(Out, "}\n");
+}
+
+// (Job system scaling: the parallel-for paths at 1, 2, 4, ... workers up to MaxWorkers)
+// (Each configuration restarts the job system at that worker count; speedup is against 1 worker. Light culling
+//  runs as dependent jobs (count -> prefix sum -> fill): its tile lists are checked against the 1-worker run's)
+enum bench_jobs_config{
+  BenchJobs_Rain100K,
+  BenchJobs_Rain1M,
+  BenchJobs_ComposeFull,
+  BenchJobs_LightCull256,
+
+  BenchJobs_Count
+};
+
+internal void RunJobsBench(FILE* Out, uint32 MaxWorkers, uint32 Seed){
+  const char* ConfigNames[BenchJobs_Count] = { "rain-100k", "rain-1m", "compose-full", "light-cull-256" };
+  uint32 ConfigFrames[BenchJobs_Count] = { 500, 50, 5000, 5000 };
+  rain_sim_mode SavedMode = GlobalRainSystem.Mode;
+  int32 SavedXOffset = GlobalGameMap.XOffset;
+  int32 MaxXOffset = GlobalGameMap.Width - InternalWidth;
+
+  // (Light culling input: MAX_LIGHTS lamps scattered as in -mode lights)
+  light_block_entry* CullLights = (light_block_entry*)PlatformAllocateMemory(sizeof(light_block_entry) * lighting_system::MAX_LIGHTS);
+  uint32* CullEntries = (uint32*)PlatformAllocateMemory(sizeof(uint32) * lighting_system::MAX_TILE_ENTRIES);
+  uint32* ReferenceEntries = (uint32*)PlatformAllocateMemory(sizeof(uint32) * lighting_system::MAX_TILE_ENTRIES);
+  uint32 ReferenceUsed = 0;
+  random_series Series = RandomSeed(Seed, lighting_system::MAX_LIGHTS);
+  for(uint32 i = 0; i < lighting_system::MAX_LIGHTS; ++i){
+    CullLights[i].Position[0] = RandomBetween(&Series, 0.0f, (real32)InternalWidth);
+    CullLights[i].Position[1] = RandomBetween(&Series, 0.0f, (real32)InternalHeight);
+    CullLights[i].Radius = RandomBetween(&Series, 16.0f, 64.0f);
+  }
+
+  rain_frame RainFrame = {};
+  uint32 WorkerCounts[MAX_JOB_WORKERS];
+  uint32 WorkerCountCount = 0;
+  for(uint32 Workers = 1; Workers < MaxWorkers; Workers *= 2){ WorkerCounts[WorkerCountCount++] = Workers; }
+  WorkerCounts[WorkerCountCount++] = MaxWorkers;
+
+  fprintf(Out, "{\n");
+  fprintf(Out, "  \"mode\": \"jobs\",\n");
+  fprintf(Out, "  \"cores\": %u,\n", PlatformGetCoreCount());
+  fprintf(Out, "  \"runs\": [\n");
+  for(uint32 Config = 0; Config < BenchJobs_Count; ++Config){
+    if(Config == BenchJobs_Rain100K){ GlobalRainSystem.InitSystem(100000, 100000); }
+    else if(Config == BenchJobs_Rain1M){ GlobalRainSystem.InitSystem(1000000, 1000000); }
+    GlobalRainSystem.Mode = RainSim_CPU;
+
+    uint64 SingleWorkerNS = 0;
+    for(uint32 CountIndex = 0; CountIndex < WorkerCountCount; ++CountIndex){
+      JobSystemShutdown(&GlobalJobSystem);
+      JobSystemInit(&GlobalJobSystem, WorkerCounts[CountIndex]);
+
+      uint32 Frames = ConfigFrames[Config];
+      uint32 CullUsed = 0;
+      uint64 StartNS = BenchGetWallClockNS();
+      for(uint32 Frame = 0; Frame < Frames; ++Frame){
+	if(Config == BenchJobs_ComposeFull){
+	  GlobalGameMap.XOffset = Frame % (MaxXOffset + 1);
+	  StreamWorldChunks(&GlobalGameMap);
+	  CompositeMapRegion(0, InternalHeight, 0, InternalWidth);
+	}
+	else if(Config == BenchJobs_LightCull256){
+	  CullUsed = CullLightTiles(CullLights, lighting_system::MAX_LIGHTS, CullEntries);
+	}
+	else{
+	  GlobalRainSystem.Update(&RainFrame);
+	}
+      }
+      uint64 ElapsedNS = BenchGetWallClockNS() - StartNS;
+      if(CountIndex == 0){ SingleWorkerNS = ElapsedNS; }
+
+      bool32 Last = (Config == BenchJobs_Count - 1) && (CountIndex == WorkerCountCount - 1);
+      fprintf(Out, "    {\"config\": \"%s\", \"workers\": %u, \"frames\": %u, \"us_per_frame\": %.3f, \"speedup\": %.2f",
+	      ConfigNames[Config], WorkerCounts[CountIndex], Frames, ((real64)ElapsedNS / 1e3) / Frames,
+	      (real64)SingleWorkerNS / (real64)ElapsedNS);
+      if(Config == BenchJobs_LightCull256){
+	if(CountIndex == 0){
+	  ReferenceUsed = CullUsed;
+	  memcpy(ReferenceEntries, CullEntries, sizeof(uint32) * CullUsed);
+	}
+	bool32 Matches = (CullUsed == ReferenceUsed) && (memcmp(CullEntries, ReferenceEntries, sizeof(uint32) * CullUsed) == 0);
+	if(!Matches){ fprintf(stderr, "bench: light culling at %u workers differs from 1 worker\n", WorkerCounts[CountIndex]); }
+	fprintf(Out, ", \"tile_entries\": %u, \"matches_1_worker\": %s", CullUsed, Matches ? "true" : "false");
+      }
+      fprintf(Out, "}%s\n", Last ? "" : ",");
+    }
+  }
+  fprintf(Out, "  ]\n");
+  fprintf(Out, "}\n");
+
+  GlobalRainSystem.Mode = SavedMode;
+  GlobalGameMap.XOffset = SavedXOffset;
+  GlobalCompositor.Valid = false;
+  if(RainFrame.Instances){ PlatformFreeMemory(RainFrame.Instances); }
+  PlatformFreeMemory(CullLights);
+  PlatformFreeMemory(CullEntries);
+  PlatformFreeMemory(ReferenceEntries);
+}
+
+/* Driver Function */
+// (Usage: bench [-mode frames|compose|rain|rain-scaling|jobs|pacing|lights|cook|startup|walk] [-render gpu|cpu] [-normals load|trig] [-rain cpu|stateless|feedback] [-drops N] [-threads N] [-pipeline] [-gl null|egl] [-sim-hz N] [-render-hz N] [-frames N] [-script file] [-seed N] [-pack file] [-world-width N] [-out report.json] [-verbose])
+// (-mode compose: -frames is the iteration count; -mode rain / rain-scaling / jobs ignore -frames; -drops: stateless / feedback rain instance count)
+// (-mode pacing: -frames intervals per frame-pacer strategy at -render-hz (default 144))
+// (-mode cook: write the scene pack (-pack, default ../media/Scene1.pack) from the PNGs; -mode startup: scene
+//  load from the PNGs vs the pack, cold and warm)
+// (-world-width: -mode cook repeats the scene across a world that wide; -mode walk crosses such a pack (-pack),
+//  steps paced at -sim-hz if given, else back to back)
+// (-mode lights: tiled vs light-volume lighting at 8 .. 256 lights scattered with -seed)
+// (-threads: job workers including the main thread (default: one per core); -mode jobs scales up to it)
+// (-pipeline: render stages on a render thread fed through the frame queue, as in the game; otherwise inline)
+// (-gl: null (default) stubs GL out, so only CPU-side submit cost is measured; egl draws for real in a headless
+//  BENCH_GL_WIDTH x BENCH_GL_HEIGHT pbuffer, for the GPU times of -mode rain-scaling / lights)
+// (-sim-hz / -render-hz: inline renders follow a virtual clock, -frames sim steps at -sim-hz (default 30) drawn
+//  -render-hz times a second (default: once per step), blended as in the game)
+int main(int ArgCount, char** Args){
+  int32 FrameCount = 2000;
+  const char* Mode = "frames";
+  render_mode RenderMode = RenderMode_GPUScroll;
+  rain_sim_mode RainMode = RainSim_CPU;
+  uint32 GPUDrops = 0; // (Stateless / feedback rain instance count, 0: same count as the CPU path)
+  char* ScriptName = 0;
+  char* OutName = 0;
+  char* PackName = "../media/Scene1.pack";
+  int32 WorldWidth = 0; // (0: the scene's own)
+  bool32 SimHzGiven = false;
+  uint32 Seed = 1;
+  uint32 Threads = PlatformGetCoreCount();
+  bool32 Pipeline = false;
+  real64 RenderHz = 0.0; // (0: one render per sim step)
+
+  for(int i = 1; i < ArgCount; ++i){
+    bool32 HasValue = (i + 1 < ArgCount);
+    if(strcmp(Args[i], "-mode") == 0 && HasValue){ Mode = Args[++i]; }
+    else if(strcmp(Args[i], "-render") == 0 && HasValue){
+      RenderMode = (strcmp(Args[++i], "cpu") == 0) ? RenderMode_CPUComposite : RenderMode_GPUScroll;
+    }
+    else if(strcmp(Args[i], "-normals") == 0 && HasValue){
+      GlobalNormalDecode = (strcmp(Args[++i], "trig") == 0) ? NormalDecode_Trig : NormalDecode_Load;
+    }
+    else if(strcmp(Args[i], "-rain") == 0 && HasValue){
+      char* Name = Args[++i];
+      RainMode = (strcmp(Name, "stateless") == 0) ? RainSim_Stateless : (strcmp(Name, "feedback") == 0) ? RainSim_Feedback : RainSim_CPU;
+    }
+    else if(strcmp(Args[i], "-drops") == 0 && HasValue){ GPUDrops = (uint32)strtoul(Args[++i], 0, 10); }
+    else if(strcmp(Args[i], "-threads") == 0 && HasValue){ Threads = (uint32)strtoul(Args[++i], 0, 10); }
+    else if(strcmp(Args[i], "-frames") == 0 && HasValue){ FrameCount = atoi(Args[++i]); }
+    else if(strcmp(Args[i], "-script") == 0 && HasValue){ ScriptName = Args[++i]; }
+    else if(strcmp(Args[i], "-seed") == 0 && HasValue){ Seed = (uint32)strtoul(Args[++i], 0, 10); }
+    else if(strcmp(Args[i], "-out") == 0 && HasValue){ OutName = Args[++i]; }
+    else if(strcmp(Args[i], "-pack") == 0 && HasValue){ PackName = Args[++i]; }
+    else if(strcmp(Args[i], "-world-width") == 0 && HasValue){ WorldWidth = atoi(Args[++i]); }
+    else if(strcmp(Args[i], "-pipeline") == 0){ Pipeline = true; }
+    else if(strcmp(Args[i], "-gl") == 0 && HasValue){ GlobalBenchRealGL = (strcmp(Args[++i], "egl") == 0); }
+    else if(strcmp(Args[i], "-sim-hz") == 0 && HasValue){ GlobalSimHz = atof(Args[++i]); SimHzGiven = true; }
+    else if(strcmp(Args[i], "-render-hz") == 0 && HasValue){ RenderHz = atof(Args[++i]); }
+    else if(strcmp(Args[i], "-verbose") == 0){ GlobalBenchVerbose = true; }
+    else{
+      fprintf(stderr, "usage: %s [-mode frames|compose|rain|rain-scaling|jobs|pacing|lights|cook|startup|walk] [-render gpu|cpu] [-normals load|trig] [-rain cpu|stateless|feedback] [-drops N] [-threads N] [-pipeline] [-gl null|egl] [-sim-hz N] [-render-hz N] [-frames N] [-script file] [-seed N] [-pack file] [-world-width N] [-out report.json] [-verbose]\n", Args[0]);
+      return 1;
+    }
+  }
+  if(FrameCount <= 0){ FrameCount = 1; }
+  if(GlobalSimHz <= 0.0){ GlobalSimHz = 30.0; }
+  GlobalRenderHz = (RenderHz > 0.0) ? RenderHz : GlobalSimHz;
+  if(Threads < 1){ Threads = 1; }
+  if(Threads > MAX_JOB_WORKERS){ Threads = MAX_JOB_WORKERS; }
+
+  bench_input_script Script;
+  if(ScriptName){
+    if(!LoadInputScript(&Script, ScriptName)){
+      fprintf(stderr, "bench: could not load input script %s\n", ScriptName);
+      return 1;
+    }
+  }
+  else{
+    DefaultInputScript(&Script);
+  }
+
+  if(GlobalBenchRealGL){
+    // (The per-frame GL traffic counts come from the null stubs, and the context is current on this thread only)
+    if(strcmp(Mode, "rain-scaling") != 0 && strcmp(Mode, "lights") != 0){
+      fprintf(stderr, "bench: -gl egl only applies to -mode rain-scaling and -mode lights\n");
+      return 1;
+    }
+    if(!EGLGLInit(BENCH_GL_WIDTH, BENCH_GL_HEIGHT)){
+      fprintf(stderr, "bench: EGL context creation failed\n");
+      return 1;
+    }
+    if(GlobalBenchVerbose){ fprintf(stderr, "bench: GL %s (%s)\n", glGetString(GL_VERSION), glGetString(GL_RENDERER)); }
+  }
+  else if(!NullGLInit()){
+    fprintf(stderr, "bench: null GL initialization failed\n");
+    return 1;
+  }
+
+  GlobalProfiler.CyclesPerSecond = BenchEstimateCPUTimerFrequency();
+  srand(Seed); // (AoS reference kernel only)
+  JobSystemInit(&GlobalJobSystem, Threads);
+  InitGlobalGLRendering(Seed);
+
+  FILE* Out = stdout;
+  if(OutName){
+    Out = fopen(OutName, "w");
+    if(!Out){
+      fprintf(stderr, "bench: could not open %s\n", OutName);
+      return 1;
+    }
+  }
+
+  // (Before LoadGameScene: these load the scene themselves, and startup / walk need the files unmapped to evict them)
+  if(strcmp(Mode, "cook") == 0){
+    int Result = RunCook(Out, PackName, WorldWidth);
+    UnloadGameScene();
+    if(Out != stdout){ fclose(Out); }
+    return Result;
+  }
+  else if(strcmp(Mode, "startup") == 0){
+    int Result = RunStartupBench(Out, PackName);
+    if(Out != stdout){ fclose(Out); }
+    return Result;
+  }
+  else if(strcmp(Mode, "walk") == 0){
+    SetRenderMode(RenderMode);
+    int Result = RunWalkBench(Out, PackName, SimHzGiven ? GlobalSimHz : 0.0);
+    UnloadGameScene();
+    if(Out != stdout){ fclose(Out); }
+    return Result;
+  }
+
+  LoadGameScene();
+  SetRenderMode(RenderMode);
+  GlobalRainSystem.Mode = RainMode;
+  if(GPUDrops){
+    if(RainMode == RainSim_Stateless){ GlobalRainSystem.InitStateless(GPUDrops); }
+    else if(RainMode == RainSim_Feedback){ GlobalRainSystem.InitFeedback(GPUDrops); }
+  }
+  // (LoadGameScene composed the first screen)
+  if(!GlobalGLRenderer.Pixels[0] && !GlobalGLRenderer.Pixels[OX(InternalHeight - 1, InternalWidth - 1)]){
+    fprintf(stderr, "bench: warning: game map looks empty (run from the build directory so ../media resolves)\n");
+  }
+  // (Only count per-frame GL traffic)
+  GlobalNullGLStats = {};
+
+  if(strcmp(Mode, "compose") == 0){
+    RunComposeBench(Out, FrameCount);
+    UnloadGameScene();
+    if(Out != stdout){ fclose(Out); }
+    return 0;
+  }
+  else if(strcmp(Mode, "rain") == 0){
+    RunRainBench(Out);
+    UnloadGameScene();
+    if(Out != stdout){ fclose(Out); }
+    return 0;
+  }
+  else if(strcmp(Mode, "rain-scaling") == 0){
+    RunRainScalingBench(Out);
+    UnloadGameScene();
+    EGLGLShutdown();
+    if(Out != stdout){ fclose(Out); }
+    return 0;
+  }
+  else if(strcmp(Mode, "lights") == 0){
+    RunLightsBench(Out, Seed);
+    UnloadGameScene();
+    EGLGLShutdown();
+    if(Out != stdout){ fclose(Out); }
+    return 0;
+  }
+  else if(strcmp(Mode, "pacing") == 0){
+    RunPacingBench(Out, FrameCount, (RenderHz > 0.0) ? RenderHz : 144.0);
+    UnloadGameScene();
+    if(Out != stdout){ fclose(Out); }
+    return 0;
+  }
+  else if(strcmp(Mode, "jobs") == 0){
+    RunJobsBench(Out, Threads, Seed);
+    JobSystemShutdown(&GlobalJobSystem);
+    UnloadGameScene();
+    if(Out != stdout){ fclose(Out); }
+    return 0;
+  }
+
+  game_input Input[2] = {};
+  game_input* NewInput = &Input[0];
+  game_input* OldInput = &Input[1];
+
+  if(Pipeline){
+    GlobalFrameQueue.PublishSemaphore = PlatformCreateSemaphore(1 << 30);
+    GlobalBenchRenderThread.Thread = PlatformCreateThread(BenchRenderThreadProc, &GlobalBenchRenderThread);
+  }
+
+  real64 SimStep = 1.0 / GlobalSimHz;
+  real64 RenderStep = 1.0 / GlobalRenderHz;
+  uint64 RenderTicks = 0;
+
+  uint64 LoopStartNS = BenchGetWallClockNS();
+  for(int32 Frame = 0; Frame < FrameCount; ++Frame){
+    real64 DueTime = Frame * SimStep;
+    ProfileBeginFrame(ProfileRing_Sim);
+    uint64 StageStartNS = BenchGetWallClockNS();
+    if(GlobalGLRenderer.Mode == RenderMode_CPUComposite){
+      LoadInternalMap();
+    }
+    uint64 StageEndNS = BenchGetWallClockNS();
+    BenchRecordStage(BenchStage_LoadInternalMap, StageStartNS, StageEndNS);
+
+    StageStartNS = StageEndNS;
+    BenchSampleInput(&Script, Frame, NewInput);
+    ProcessGameInput(NewInput, OldInput);
+    StageEndNS = BenchGetWallClockNS();
+    BenchRecordStage(BenchStage_ProcessGameInput, StageStartNS, StageEndNS);
+
+    StageStartNS = StageEndNS;
+    GlobalRainSystem.Update(&SimRenderFrame(&GlobalFrameQueue)->Rain);
+    StageEndNS = BenchGetWallClockNS();
+    BenchRecordStage(BenchStage_RainUpdate, StageStartNS, StageEndNS);
+
+    StageStartNS = StageEndNS;
+    BuildRenderFrame(&GlobalFrameQueue, DueTime);
+    PublishRenderFrame(&GlobalFrameQueue);
+    StageEndNS = BenchGetWallClockNS();
+    BenchRecordStage(BenchStage_PublishFrame, StageStartNS, StageEndNS);
+
+    if(!Pipeline){
+      // (Every render tick before the next step is due draws this one)
+      // (Compared against (Frame + 1) * SimStep, not DueTime + SimStep: the same product on both sides keeps
+      //  equal rates at exactly one render per step)
+      for(; RenderTicks * RenderStep < (Frame + 1) * SimStep; ++RenderTicks){
+	render_frame* RenderFrame = LatestRenderFrame(&GlobalFrameQueue);
+	BenchRenderFrame(RenderFrame, RenderFrameBlend(RenderFrame, RenderTicks * RenderStep, GlobalSimHz));
+      }
+    }
+
+    game_input* Temp = NewInput;
+    NewInput = OldInput;
+    OldInput = Temp;
+    ProfileEndFrame(ProfileRing_Sim);
+  }
+  uint64 LoopEndNS = BenchGetWallClockNS();
+  if(Pipeline){
+    GlobalBenchRenderThread.Quit = 1;
+    PlatformSignalSemaphore(GlobalFrameQueue.PublishSemaphore, 1);
+    PlatformJoinThread(GlobalBenchRenderThread.Thread);
+    // (The last published frame may still be unread: draw it so the end state matches an inline run)
+    render_frame* LastFrame = AcquireRenderFrame(&GlobalFrameQueue);
+    if(LastFrame){ BenchRenderFrame(LastFrame, 1.0f); }
+  }
+
+  WriteBenchReport(Out, FrameCount, LoopEndNS - LoopStartNS, ScriptName ? ScriptName : "default", Seed);
+  UnloadGameScene();
+  if(Out != stdout){ fclose(Out); }
+
+  return 0;
+}
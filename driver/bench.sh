@@ -0,0 +1,8 @@
+#!/bin/sh
+# Headless benchmark build (Linux, no display needed; libEGL for -gl egl): see bench.cpp
+mkdir -p ../build
+cd ../build
+cc -O2 -c ../driver/glad.c -I../include -o glad.o || exit 1
+c++ -O2 -g -std=c++17 -Wno-write-strings ../driver/bench.cpp glad.o \
+-I../include \
+-o bench -lm -ldl -lEGL -pthread
@@ -4,232 +4,10 @@
 #include <windows.h> // (base windows functionality)
 #include <mmdeviceapi.h> // (core audio api's)
 #include <audioclient.h>
-#include <stdint.h> // (included by default with GLAD)
-#include <glad/glad.h>
-#include <GLFW/glfw3.h>
-
-#include <stdlib.h> // TODO: see if we can put in rand() ourselves without the rest of the file
-#include <math.h> // TODO: examine math implementations, see if we can hand-make? (e.g. sin)
-#include <stdio.h> // (for temporary debugging (sprintf for performance tracking))
-
-#define global_variable static
-#define internal static
-
-typedef uint8_t uint8;
-typedef uint16_t uint16;
-typedef uint32_t uint32;
-typedef uint64_t uint64;
-
-typedef int16_t int16;
-typedef int32_t int32;
-typedef int64_t int64;
-
-typedef float real32;
-typedef double real64;
-
-typedef int32_t bool32;
-
-// (Used in particle structs)
-// (Resolution Width, Height)
-global_variable const uint32 InternalWidth = 320;
-global_variable const uint32 InternalHeight = 180;
-
-// (Internal Display)
-// (Internal translation: column-major)
-#define IX(i,j) ((i)+((j)*InternalHeight))
-// (OpenGL translation: row-major)
-#define OX(i,j) (((i)*InternalWidth)+(j))
-#define ArrayCount(arr) (sizeof(arr) / sizeof(arr[0]))
-
-// TODO: refactor for differently-sized sprites
-global_variable const uint32 SpriteWidth = 15;
-global_variable const uint32 SpriteHeight = 20;
-global_variable const uint32 SpritePitch = 10; // (Probably won't have to use)
-global_variable const uint32 SpriteMapWidth = 75;
-global_variable const uint32 SpriteMapHeight = 20;
-
-// [(i % SpritePitch) * SpriteWidth, (i / SpritePitch) * SpriteHeight]
-// #define SpritePosition(i) OX((),())
-// #define SpritePosition(i) [(((i)%SpritePitch) * SpriteWidth), (((i)/SpritePitch)*SpriteHeight)]
-
-// (Full Width for game map: used in image.h)
-global_variable const uint32 FullWidth = 720; // TODO: change to final full width of game / determine from full map
-// (Used for error checking in raindrop struct functions)
-internal void CheckGLError(char* label);
-
-struct game_map{
-  uint32* Pixels;
-  uint32* Angles; // (Angles provided by normal map)
-  int32 Width;
-  // (Height = InternalHeight)
-  int32 XOffset;
-  // int32 PlayerOffset; // (dictates where we draw sprite)
-};
-global_variable game_map GlobalGameMap;
-
-
-struct sprite_map{
-  uint32* Pixels;
-  // int32 MapWidth;
-  // int32 MapHeight;
-};
-global_variable sprite_map GlobalSpriteMap;
-
-
-// STRUCTS
-#include "shader.h"
-// (Window structs)
-/*
-struct player_anim{
-int32 StartFrame; // (first frame of animation)
-int32 EndFrame; // (last frame of animatioN)
-int32 Direction; // (is it reversed?)
-}
- */
-struct player_state{
-  // General State: 
-  int32 AnimState = 0; // 0 = Idle, 1 = Walk
-  bool32 PlayerReversed = false;
-
-  // Animation Metadata: 
-  int32 AnimFrame = 0; // Sprite within animation
-  int32 AnimInter = 0; // Interval frame within current sprite panel
-  int32 MaxAnimInter = 6; // Number of interval frames per sprite panel
-
-  // (Animation Tags:)
-  int32 WalkStart = 1;
-  int32 WalkEnd = 5;
-  int32 WalkDirection = 1; // (Status within ping-pong animation)
-
-  int32 MovementSpeed = 1; // TODO: add floating point precision?
-  int32 LocalXOffset = 25;
-  int32 XOffset = 10;
-  int32 BottomOffset = 27;
-  
-};
-global_variable player_state GlobalPlayerState;
-
-struct GLBuffer {
-  // (Base rendering resources)
-  GLuint MainTexture;
-  GLuint FrameVAO;
-  GLuint FrameVBO;
-  GLuint FrameEBO;
-  Shader* BaseShader;
-  uint32* Pixels;
-
-  // (Normal map resources)
-  GLuint AngleTexture;
-  uint32* Angles;
-  
-  // (Rain rendering)
-  GLuint RainVAO;
-  GLuint RainVBO; // (single-raindrop vertex data)
-  GLuint RainInstanceVBO; // (data for instances)
-  GLuint RainTexture;
-  Shader* RainShader;
-};
-global_variable GLBuffer GlobalGLRenderer;
-// (I like putting image.h here, shader.h should also be fine?)
-
-struct light_source{
-  real32 PosX, PosY;
-  real32 R, G, B;
-  real32 Intensity;
-  real32 Radius;
-  bool32 Active;
-};
-struct lighting_system{
-  static const int MAX_LIGHTS = 8;
-  light_source Lights[MAX_LIGHTS];
-  int ActiveLightCount;
-
-  void AddLight(real32 PosX, real32 PosY, real32 R, real32 G,
-	       real32 B, real32 Intensity, real32 Radius){
-    if(ActiveLightCount >= MAX_LIGHTS){ return; }
-    int idx = ActiveLightCount++;
-
-    // (Copy aspects)
-    Lights[idx].PosX = PosX;
-    Lights[idx].PosY = PosY;
-    Lights[idx].R = R;
-    Lights[idx].G = G;
-    Lights[idx].B = B;
-    Lights[idx].Intensity = Intensity;
-    Lights[idx].Radius = Radius;
-    Lights[idx].Active = true;
-  }
-
-  void ClearLight(Shader* LightShader, int32 Index){
-    if(Index < 0 || Index >= ActiveLightCount) { return; }
-    if(Lights[Index].Active){
-    Lights[Index].Active = false;
-    // (Zero out values in shader)
-    char buf[64];
-    sprintf(buf, "lights[%d].position", Index);
-    LightShader->SetVec2(buf, 0.0f, 0.0f);
-    sprintf(buf, "lights[%d].color", Index);
-    LightShader->SetVec3(buf, 0.0f, 0.0f, 0.0f);
-    sprintf(buf, "lights[%d].intensity", Index);
-    LightShader->SetFloat(buf, 0.0f);
-    sprintf(buf, "lights[%d].radius", Index);
-    LightShader->SetFloat(buf, 0.0f);
-
-    ActiveLightCount--;
-    }
-  }
-  
-  void UpdateLightUniforms(Shader* LightShader){
-    // LightShader->Use();
-
-    LightShader->SetInt("numActiveLights", ActiveLightCount);
-    
-    for(int i = 0; i < ActiveLightCount; ++i){
-      if(!Lights[i].Active){ continue; }
-
-      char buf[64];
-      // OutputDebugStringA("\n\n");
-      sprintf(buf, "lights[%d].position", i);
-      LightShader->SetVec2(buf, Lights[i].PosX, Lights[i].PosY);
-      sprintf(buf, "lights[%d].color", i); 
-      LightShader->SetVec3(buf, Lights[i].R, Lights[i].G, Lights[i].B);
-      sprintf(buf, "lights[%d].intensity", i);
-      LightShader->SetFloat(buf, Lights[i].Intensity);      
-      sprintf(buf, "lights[%d].radius", i);
-      LightShader->SetFloat(buf, Lights[i].Radius);
-    }
-
-    LightShader->SetFloat("ambientStrength", 0.2f);
-    
-  }
-
-  void MoveLightShader(Shader* LightShader, int32 XOffset){
-    // move all light shaders
-    // TODO: set player light to 0th index and have this be i. Then can have a separate fn for player x offset which we want to update every frame
-    // TODO: refine logic
-
-    for(int i = 0; i < ActiveLightCount; ++i){
-      if(!Lights[i].Active){
-	continue;
-      }
-      
-      if(Lights[i].PosX - GlobalGameMap.XOffset < -100 || Lights[i].PosX - GlobalGameMap.XOffset > 420){
-	// TODO: (fix indexing logic?)
-	ClearLight(LightShader, i);
-      }
-      
-      char buf[64];
-      sprintf(buf, "lights[%d].position", i);
-      LightShader->SetVec2(buf, Lights[i].PosX, Lights[i].PosY);
-      
-    }
-  }
-    
-};
-global_variable lighting_system GlobalLightingSystem;
-
 
-#include "media.h"
+// (Platform-independent game code: structs, lighting, rain, input handling, map composition)
+#include "game.h" // (includes GLAD: must precede GLFW)
+#include <GLFW/glfw3.h>
 
 // (Pixel dimensions of current window)
 struct win64_window_dimension
@@ -247,402 +25,212 @@ struct win64_offscreen_buffer
   int Pitch;
   int BytesPerPixel;
  };
-// (Internal game metadata for window blitting)
-struct game_offscreen_buffer
-{
-  int Width;
-  int Height;
-  int Pitch;
-  void *Memory;
-}; 
 
-// (Input structs)
-struct game_button_state {
-  // int HalfTransitionCount;
-  bool EndedDown;
-};
-struct game_input {  
-  union{
-    game_button_state Buttons[2];
-    struct{
-      // game_button_state Up;
-      // game_button_state Down;
-      game_button_state Left;
-      game_button_state Right;
-      // game_button_state LeftShoulder;
-      // game_button_state RightShoulder;
-    };
-  };
-  
-};
+// (GLOBALS)
 
-// (Sound structs)
-struct game_sound_output_buffer
-{
-  int SamplesPerSecond;
-  int16 SampleCount;
-  int16 *Samples;
-};
+// (Audio)
+const IID IID_IAudioClient = __uuidof(IAudioClient);
+const IID IID_IAudioRenderClient = __uuidof(IAudioRenderClient);
+global_variable IAudioClient* pAudioClientGlobal;
+global_variable IAudioRenderClient* pRenderClientGlobal;
+global_variable UINT32 bufferFrameCountGlobal;
+global_variable real32 sampleRateGlobal;
 
-// (Particle structs)
-struct game_raindrop {
-  real32 PosX, PosY;
-  real32 Angle, Velocity;
-  real32 Size; // (Radius in pixels)
-  bool32 Active;
-};
-struct rain_system {
-  internal const uint32 MAX_RAINDROPS = 1000;
-  game_raindrop GameRaindrops[MAX_RAINDROPS];
-  uint32 ActiveCount;
-
-  const real32 RainVertices[16] = {
-    // positions     // texture coords
-    -0.5f, -0.5f,   0.0f, 0.0f,
-    0.5f, -0.5f,   1.0f, 0.0f,
-    0.5f,  0.5f,   1.0f, 1.0f,
-    -0.5f,  0.5f,   0.0f, 1.0f
-  };
-
-  void InitGL(){
-    
-    real32 RainVertices[] = {
-      // positions     // texture coords
-      -0.5f, -0.5f,   0.0f, 0.0f,
-      0.5f, -0.5f,   1.0f, 0.0f,
-      0.5f,  0.5f,   1.0f, 1.0f,
-      -0.5f,  0.5f,   0.0f, 1.0f
-    };
-
-    // Generate and bind rain VAO/VBO
-    glGenVertexArrays(1, &GlobalGLRenderer.RainVAO);
-    glGenBuffers(1, &GlobalGLRenderer.RainVBO);
-    glGenBuffers(1, &GlobalGLRenderer.RainInstanceVBO);
-        
-    glBindVertexArray(GlobalGLRenderer.RainVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, GlobalGLRenderer.RainVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(RainVertices), RainVertices, GL_STATIC_DRAW);
-
-    // (Positions)
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(real32), (void*)0);
-    glEnableVertexAttribArray(0);
-
-    // (Texture coords)
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(real32), (void*)(2 * sizeof(real32)));
-    glEnableVertexAttribArray(1);
-
-    glBindBuffer(GL_ARRAY_BUFFER, GlobalGLRenderer.RainInstanceVBO);
-
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(real32), (void*)0);  // Position
-    glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(real32), (void*)(2 * sizeof(real32))); // Velocity
-
-    glEnableVertexAttribArray(2);
-    glEnableVertexAttribArray(3);
-
-    glVertexAttribDivisor(2, 1);  // Instance rate for position
-    glVertexAttribDivisor(3, 1);  // Instance rate for velocity	  
-
-    glGenTextures(1, &GlobalGLRenderer.RainTexture);
-    glBindTexture(GL_TEXTURE_2D, GlobalGLRenderer.RainTexture);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    const int32 TEX_SIZE = 32;
-    unsigned char texData[TEX_SIZE * TEX_SIZE];
-
-    // (Base texture)
-    /* 
-       for(int y = 0; y < TEX_SIZE; y++) {
-       for(int x = 0; x < TEX_SIZE; x++) {
-       texData[y*TEX_SIZE + x] = 255;
-       }
-       }
-    */
-    // (Ellipse texture:)
-    for(int y = 0; y < TEX_SIZE; y++) {
-      for(int x = 0; x < TEX_SIZE; x++) {
-	float dx = (x - TEX_SIZE/2.0f) / (TEX_SIZE/4.0f);
-	float dy = (y - TEX_SIZE/2.0f) / (TEX_SIZE/2.0f);
-	float dist = dx*dx + dy*dy;
-	texData[y*TEX_SIZE + x] = (dist <= 1.0f) ? 255 : 0;
-      }}
-	
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, TEX_SIZE, TEX_SIZE, 0,
-		 GL_RED, GL_UNSIGNED_BYTE, texData);
-    
-}
+global_variable bool GlobalRunning;
+global_variable bool GlobalProfileReportRequested;
+global_variable win64_offscreen_buffer GlobalBackBuffer;
+global_variable int64 GlobalPerfCountFrequency;
+global_variable bool32 GlobalSleepIsGranular; // (timeBeginPeriod(1) took: timers are accurate to ~1ms)
 
-  // TODO: Rename ('initsystem')
-  void InitSystem(){
-    //ActiveCount = MAX_RAINDROPS / 2;
-    ActiveCount = .9 * MAX_RAINDROPS;
-    for(int i = 0; i < ActiveCount; ++i){
-      InitDrop(GameRaindrops[i]);
-    }
-    UpdateInstanceData();
-  }
 
-  void UpdateInstanceData(){
-    real32 InstanceDataBuffer[MAX_RAINDROPS*4];
+// PLATFORM SERVICES (Win64)
 
-    for(int i = 0; i < ActiveCount; ++i){
-      const game_raindrop& CurrentDrop = GameRaindrops[i];
-      if(!CurrentDrop.Active) continue;
+internal void PlatformOutputDebugString(char* Message){
+  OutputDebugStringA(Message);
+}
 
-      InstanceDataBuffer[i * 4] = CurrentDrop.PosX;
-      InstanceDataBuffer[i * 4 + 1] = CurrentDrop.PosY;
-      InstanceDataBuffer[i * 4 + 2] = CurrentDrop.Velocity * sin(CurrentDrop.Angle);
-      InstanceDataBuffer[i * 4 + 3] = -CurrentDrop.Velocity * cos(CurrentDrop.Angle);
-    }
+internal void* PlatformAllocateMemory(size_t Size){
+  // (VirtualAlloc returns zeroed pages)
+  return VirtualAlloc(0, Size, MEM_RESERVE|MEM_COMMIT, PAGE_READWRITE);
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, GlobalGLRenderer.RainInstanceVBO);
-    glBufferData(GL_ARRAY_BUFFER,
-		 sizeof(real32) * ActiveCount * 4,
-		 InstanceDataBuffer,
-		 GL_DYNAMIC_DRAW);
+internal void PlatformFreeMemory(void* Memory){
+  VirtualFree(Memory, 0, MEM_RELEASE);
+}
 
-    
+internal ProcessedFile PlatformReadEntireFile(char* Filename){
+  ProcessedFile Result = {};
+  HANDLE FileHandle = CreateFileA(Filename, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, 0, 0);
+  if(FileHandle != INVALID_HANDLE_VALUE){
+    LARGE_INTEGER FileSize;
+    if(GetFileSizeEx(FileHandle, &FileSize)){
+      uint32 FileSize32 = (uint32)FileSize.QuadPart;
+      Result.Contents = VirtualAlloc(0, FileSize32, MEM_RESERVE|MEM_COMMIT, PAGE_READWRITE);
+      if(Result.Contents){
+	DWORD BytesRead;
+	if(ReadFile(FileHandle, Result.Contents, FileSize32, &BytesRead, 0) && (FileSize32 == BytesRead)){
+	  Result.ContentsSize = FileSize32;
+	}
+	else{
+	  if(Result.Contents){
+	    VirtualFree(Result.Contents, 0, MEM_RELEASE);
+	    Result.Contents = 0;
+	  }
+	}
+      }
+    }
+    CloseHandle(FileHandle);
   }
-  
-  void Update(){
-    for(int i = 0; i < ActiveCount; ++i){
-      game_raindrop& Drop = GameRaindrops[i];
-      if(!Drop.Active) continue;
-      
-      // (Move pixel along velocity if defined)
-      Drop.PosX += Drop.Velocity * sin(Drop.Angle);;
-      Drop.PosY += Drop.Velocity * cos(Drop.Angle);
-      // (Angle, Velocity, Size remain constant)
-    
-      // (Check for ground collision)
-      if(Drop.PosY < 0 || Drop.PosX < 0){
-	// (resetting logic)
-	Reset(Drop);
+  return Result;
+}
+
+internal mapped_file PlatformMapFile(char* Filename){
+  mapped_file Result = {};
+  HANDLE FileHandle = CreateFileA(Filename, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, 0, 0);
+  if(FileHandle != INVALID_HANDLE_VALUE){
+    LARGE_INTEGER FileSize;
+    if(GetFileSizeEx(FileHandle, &FileSize) && FileSize.QuadPart > 0){
+      // (PAGE_WRITECOPY / FILE_MAP_COPY: writes go to private pages, never to the file)
+      HANDLE Mapping = CreateFileMappingA(FileHandle, 0, PAGE_WRITECOPY, 0, 0, 0);
+      if(Mapping){
+	Result.Memory = MapViewOfFile(Mapping, FILE_MAP_COPY, 0, 0, 0);
+	if(Result.Memory){ Result.Size = (uint64)FileSize.QuadPart; }
+	CloseHandle(Mapping); // (The view keeps the mapping alive)
       }
     }
-    UpdateInstanceData();
+    CloseHandle(FileHandle);
   }
+  return Result;
+}
 
-  void Reset(game_raindrop& Drop){
-    // (When drop reaches bottom of screen)
+internal void PlatformUnmapFile(mapped_file* File){
+  if(File->Memory){ UnmapViewOfFile(File->Memory); }
+  File->Memory = 0;
+  File->Size = 0;
+}
 
-    // TODO: improve randomization to be more even (currently skews towards right)
-    real32 x = (real32)(rand() % (InternalHeight + InternalWidth + 20));
-    Drop.PosX = x > (InternalWidth + 10) ? (InternalWidth + 10) : x;
-    Drop.PosY = x > (InternalWidth + 10) ?  x - (InternalWidth + 10) : (InternalHeight + 10);
-    
-    // Drop.PosX = (real32)(rand() % InternalWidth);
-    // Drop.PosY = (real32)(InternalHeight - 10); // TODO: do we need to randomize? e.g. (real32)(InternalHeight + (rand() % 50));
-    
-    // (set random angle: (4 - 4.5 radians))
-    // Drop.Angle = 4.0f + (0.5f * ((real32)rand() / RAND_MAX));
-    // Drop.Angle = 3.14;
-    
-    // Drop.Angle = 3.5f + (0.5f * ((real32)rand() / RAND_MAX));
-    Drop.Angle = 3.5f;
-    
-    // (set random velocity: (3 - 5))
-    // Drop.Velocity = 3.5f + (2.0f * ((real32)rand() / RAND_MAX));
-    Drop.Velocity = 4.5f + (2.0f * ((real32)rand() / RAND_MAX));
-    
-    // (size, active)
-    Drop.Size = 1.0f + ((real32)rand() / RAND_MAX); // TODO: can size be uniform?
-    Drop.Active = true;
-  }
+internal void* PlatformOpenFileForReading(char* Filename){
+  HANDLE FileHandle = CreateFileA(Filename, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, 0);
+  return (FileHandle != INVALID_HANDLE_VALUE) ? FileHandle : 0;
+}
 
-  void InitDrop(game_raindrop& Drop){
-    // (When drop is uninialized)
-    Drop.PosX = (real32)(rand() % InternalWidth);
-    Drop.PosY = (real32)(rand() % InternalHeight);
-    
-    // Drop.Angle = 3.5f + (0.5f * ((real32)rand() / RAND_MAX));
-    Drop.Angle = 3.5f;
-    Drop.Velocity = 4.5f + (2.0f * ((real32)rand() / RAND_MAX));
-    Drop.Size = 1.0f + ((real32)rand() / RAND_MAX); 
-    Drop.Active = true;    
-  }
-  
-};
-global_variable rain_system GlobalRainSystem;
+// (Synchronous handle: the OVERLAPPED only carries the offset, so concurrent reads never share a file pointer)
+internal bool32 PlatformReadFileAt(void* File, uint64 Offset, void* Dest, uint32 Size){
+  OVERLAPPED Overlapped = {};
+  Overlapped.Offset = (DWORD)(Offset & 0xFFFFFFFF);
+  Overlapped.OffsetHigh = (DWORD)(Offset >> 32);
+  DWORD BytesRead = 0;
+  return ReadFile((HANDLE)File, Dest, Size, &BytesRead, &Overlapped) && BytesRead == Size;
+}
 
-// (GLOBALS)
+internal void PlatformCloseFile(void* File){
+  if(File){ CloseHandle((HANDLE)File); }
+}
 
-// (Audio)
-const IID IID_IAudioClient = __uuidof(IAudioClient);
-const IID IID_IAudioRenderClient = __uuidof(IAudioRenderClient);
-global_variable IAudioClient* pAudioClientGlobal;
-global_variable IAudioRenderClient* pRenderClientGlobal;
-global_variable UINT32 bufferFrameCountGlobal;
-global_variable real32 sampleRateGlobal;
+// (Thread entry trampoline: CreateThread wants a DWORD WINAPI (LPVOID) proc)
+struct win64_thread_start{
+  platform_thread_proc* Proc;
+  void* Data;
+};
 
-global_variable bool GlobalRunning;
-global_variable win64_offscreen_buffer GlobalBackBuffer;
+internal DWORD WINAPI Win64ThreadProc(LPVOID Parameter){
+  win64_thread_start Start = *(win64_thread_start*)Parameter;
+  PlatformFreeMemory(Parameter);
+  Start.Proc(Start.Data);
+  return 0;
+}
 
-// (Colors)
-global_variable const uint32 Red = (0xFF << 24);
-global_variable const uint32 Green = (0xFF << 16);
-global_variable const uint32 Blue = (0xFF << 8);
-global_variable const uint32 Alpha = 0XFF;
+internal void* PlatformCreateThread(platform_thread_proc* Proc, void* Data){
+  win64_thread_start* Start = (win64_thread_start*)PlatformAllocateMemory(sizeof(win64_thread_start));
+  Start->Proc = Proc;
+  Start->Data = Data;
+  return CreateThread(0, 0, Win64ThreadProc, Start, 0, 0);
+}
 
-// Framerate Control
-global_variable const int TARGET_FPS = 30;
-global_variable const real32 TARGET_SECONDS_PER_FRAME = (1.0f / (real32)TARGET_FPS);
+internal void PlatformJoinThread(void* Thread){
+  WaitForSingleObject((HANDLE)Thread, INFINITE);
+  CloseHandle((HANDLE)Thread);
+}
 
-// (Scroll speed)
-// global_variable const real32 SCROLL_SPEED = 1.0f;
-global_variable real32 GlobalScrollOffset = 0;
+internal void* PlatformCreateSemaphore(uint32 MaxCount){
+  return CreateSemaphoreEx(0, 0, MaxCount, 0, 0, SEMAPHORE_ALL_ACCESS);
+}
 
-// HELPER FUNCTIONS
+internal void PlatformDestroySemaphore(void* Semaphore){
+  CloseHandle((HANDLE)Semaphore);
+}
 
-// (OpenGL Error Checking))
-internal void CheckGLError(char* label){
-  GLenum err;
-  while((err = glGetError()) != GL_NO_ERROR) {
-    char errorMsg[256];
-    sprintf(errorMsg, "OpenGL error at %s: 0x%x\n", label, err);
-    OutputDebugStringA(errorMsg);
-  }
+internal void PlatformSignalSemaphore(void* Semaphore, uint32 Count){
+  // (Fails harmlessly past MaxCount: every sleeper is already due to wake)
+  ReleaseSemaphore((HANDLE)Semaphore, Count, 0);
 }
 
-internal real32 Win64GetSecondsElapsed(LARGE_INTEGER Start, LARGE_INTEGER End, int64 PerfCountFrequency){
-  real32 Result = ((real32)(End.QuadPart - Start.QuadPart) / (real32)PerfCountFrequency);
-  return Result;
+internal void PlatformWaitSemaphore(void* Semaphore){
+  WaitForSingleObjectEx((HANDLE)Semaphore, INFINITE, FALSE);
 }
 
-internal void ProcessGameInput(game_input* NewInput, game_input* OldInput){
+internal uint32 PlatformGetCoreCount(){
+  SYSTEM_INFO SystemInfo;
+  GetSystemInfo(&SystemInfo);
+  return SystemInfo.dwNumberOfProcessors;
+}
 
-  NewInput->Left.EndedDown = (GetAsyncKeyState(VK_LEFT) & 0x8000) != 0;
-  NewInput->Right.EndedDown = (GetAsyncKeyState(VK_RIGHT) & 0x8000) != 0;
-   
-  // OutputDebugStringA(NewInput->Left.EndedDown ? "Left key DOWN\n" : "Left key UP\n");
-  // NewInput->Right.EndedDown = true;
-
-  // Handle conflicting input:
-  if(NewInput->Left.EndedDown && NewInput->Right.EndedDown){
-    if(OldInput->Right.EndedDown && !OldInput->Left.EndedDown){
-      // Prioritize new left input
-      NewInput->Right.EndedDown = false; 
-    }
-    else{
-      NewInput->Left.EndedDown = false;
-    }
-    {
-    /* if(OldInput->Left.EndedDown && !OldInput->Right.EndedDown){
-      // Prioritize new right input
-      NewInput->Left.EndedDown = false;
-    }
-    else if(OldInput->RightEndedDown && !OldInput.LeftEndedDown){
-      // Prioritize new left input
-      NewInput->Right.EndedDown = false; 
-      } */
-    }
-  }
+// (QueryPerformanceCounter in seconds: the clock render_frame::DueTime and the pacer run on)
+internal real64 PlatformGetWallClockSeconds(){
+  LARGE_INTEGER Counter;
+  QueryPerformanceCounter(&Counter);
+  return (real64)Counter.QuadPart / (real64)GlobalPerfCountFrequency;
+}
 
-  // Animation State Handling: 
-  if(GlobalPlayerState.AnimState == 0){
-    // Prior State: Idle
+internal real64 PlatformGetThreadCPUSeconds(){
+  FILETIME Creation, Exit, Kernel, User;
+  GetThreadTimes(GetCurrentThread(), &Creation, &Exit, &Kernel, &User);
+  uint64 Ticks = (((uint64)Kernel.dwHighDateTime << 32) | Kernel.dwLowDateTime) +
+    (((uint64)User.dwHighDateTime << 32) | User.dwLowDateTime);
+  return (real64)Ticks * 1e-7; // (100ns units)
+}
 
-    if(NewInput->Left.EndedDown || NewInput->Right.EndedDown){
-      GlobalPlayerState.AnimState = 1; // (Anim State: Walking)
-      GlobalPlayerState.AnimFrame = GlobalPlayerState.WalkStart;
-    }
-    else{ /* (Remain Idle) */}
+// (Per-thread waitable timer: high resolution where the OS has it (Windows 10 1803+), otherwise a plain one
+//  at timeBeginPeriod granularity)
+thread_local HANDLE Win64ThreadTimer;
 
+internal void PlatformTimerWait(real64 Seconds){
+  if(!Win64ThreadTimer){
+    Win64ThreadTimer = CreateWaitableTimerExW(0, 0, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+    if(!Win64ThreadTimer){ Win64ThreadTimer = CreateWaitableTimerExW(0, 0, 0, TIMER_ALL_ACCESS); }
   }
-  else if(GlobalPlayerState.AnimState == 1){
-    // Prior State: Walking
-
-    if(NewInput->Left.EndedDown || NewInput->Right.EndedDown){
-      
-      GlobalPlayerState.AnimInter++;
+  LARGE_INTEGER DueTime;
+  DueTime.QuadPart = -(LONGLONG)(Seconds * 1e7); // (Relative, 100ns units)
+  if(DueTime.QuadPart < 0 && SetWaitableTimer(Win64ThreadTimer, &DueTime, 0, 0, 0, FALSE)){
+    WaitForSingleObject(Win64ThreadTimer, INFINITE);
+  }
+}
 
-      if(GlobalPlayerState.AnimInter == GlobalPlayerState.MaxAnimInter){
-	GlobalPlayerState.AnimInter = 0;
-	GlobalPlayerState.AnimFrame += GlobalPlayerState.WalkDirection;
+// HELPER FUNCTIONS
 
-	// (Change walk direction if we reach an animation bound)
-	if(GlobalPlayerState.AnimFrame == GlobalPlayerState.WalkStart){ GlobalPlayerState.WalkDirection = 1; }
-	else if(GlobalPlayerState.AnimFrame == GlobalPlayerState.WalkEnd){ GlobalPlayerState.WalkDirection = -1; }
-      }
-    }
-    else{
-      // Reset animation metadata
-      GlobalPlayerState.AnimState = 0; // (Anim State: Idle)
-      GlobalPlayerState.AnimFrame = 0; // (Idle Frame)
-      // (Reset walking-specific metadata:)
-      GlobalPlayerState.AnimInter = 0;
-      GlobalPlayerState.WalkDirection = 1;
-    }
-  }
+internal real32 Win64GetSecondsElapsed(LARGE_INTEGER Start, LARGE_INTEGER End, int64 PerfCountFrequency){
+  real32 Result = ((real32)(End.QuadPart - Start.QuadPart) / (real32)PerfCountFrequency);
+  return Result;
+}
 
-  // Irrespective Handling: Player Movement
-  if(NewInput->Left.EndedDown){
-    if(GlobalGameMap.XOffset == 0){ // Leftmost region
-      // GlobalPlayerState.XOffset = max(GlobalPlayerState.XOffset - GlobalPlayerState.MovementSpeed, 0)
-      GlobalPlayerState.XOffset = GlobalPlayerState.XOffset - GlobalPlayerState.MovementSpeed < 0 ?
-	0 : GlobalPlayerState.XOffset - GlobalPlayerState.MovementSpeed;
-    }
-    else if(GlobalGameMap.XOffset == (GlobalGameMap.Width - InternalWidth) && GlobalPlayerState.XOffset > GlobalPlayerState.LocalXOffset){ // Rightmost region
-      // GlobalPlayerState.XOffset = max(GlobalPlayerState.XOffset - GlobalPlayerState.MovementSpeed, GlobalPlayerState.LocalXOffset)
-      GlobalPlayerState.XOffset = GlobalPlayerState.XOffset - GlobalPlayerState.MovementSpeed < GlobalPlayerState.LocalXOffset ?
-	GlobalPlayerState.LocalXOffset : GlobalPlayerState.XOffset - GlobalPlayerState.MovementSpeed;
-    }
-    else{
-      // GlobalGameMap.XOffset = max(GlobalGameMap.XOffset - GlobalPlayerState.MovementSpeed, 0)
-      GlobalGameMap.XOffset = GlobalGameMap.XOffset - GlobalPlayerState.MovementSpeed < 0 ?
-	0 : GlobalGameMap.XOffset - GlobalPlayerState.MovementSpeed;     
-    }
-      
-    if(!GlobalPlayerState.PlayerReversed){GlobalPlayerState.PlayerReversed = true;}
-  }
-  
-  if(NewInput->Right.EndedDown){
+// (rdtsc ticks per second, measured against QueryPerformanceCounter: used to print profiler times)
+internal real64 Win64EstimateCPUTimerFrequency(int64 PerfCountFrequency){
+  LARGE_INTEGER StartCounter, EndCounter;
+  QueryPerformanceCounter(&StartCounter);
+  uint64 StartCycles = ReadCPUTimer();
+  do{
+    QueryPerformanceCounter(&EndCounter);
+  } while((EndCounter.QuadPart - StartCounter.QuadPart) < (PerfCountFrequency / 20));
+  uint64 EndCycles = ReadCPUTimer();
+
+  return (real64)(EndCycles - StartCycles) * (real64)PerfCountFrequency /
+    (real64)(EndCounter.QuadPart - StartCounter.QuadPart);
+}
 
-    if(GlobalPlayerState.XOffset < GlobalPlayerState.LocalXOffset){
-      // (Move player within left region)
-      // GlobalPlayerState.XOffset = min(GlobalPlayerState.LocalXOffset, GlobalPlayerState.XOffset + GlobalPlayerState.MovementSpeed)
-      GlobalPlayerState.XOffset = GlobalPlayerState.XOffset + GlobalPlayerState.MovementSpeed > GlobalPlayerState.LocalXOffset ?
-	GlobalPlayerState.LocalXOffset : GlobalPlayerState.XOffset + GlobalPlayerState.MovementSpeed;
-    }
-    else if(GlobalGameMap.XOffset == (GlobalGameMap.Width - InternalWidth)){
-      // (Move player within right region)
-      // GlobalPlayerState.XOffset = min(GlobalPlayerState.XOffset + SCROLL_SPEED, (InternalWidth - SpriteWidth))
-      int32 AdjustedWidth = InternalWidth - SpriteWidth;
-      GlobalPlayerState.XOffset = GlobalPlayerState.XOffset + GlobalPlayerState.MovementSpeed > AdjustedWidth ?
-	AdjustedWidth : GlobalPlayerState.XOffset + GlobalPlayerState.MovementSpeed;
-    }
-    else{
-      // Move screen
-      // GlobalGameMap.XOffset = min(GlobalGameMap.XOffset + GlobalPlayerState.MovementSpeed, FullWidth - InternalWidth)
-      GlobalGameMap.XOffset = GlobalGameMap.XOffset + GlobalPlayerState.MovementSpeed > (FullWidth - InternalWidth) ?
-	(FullWidth - InternalWidth) : GlobalGameMap.XOffset + GlobalPlayerState.MovementSpeed;
-      
-    }
-    
-    if(GlobalPlayerState.PlayerReversed){GlobalPlayerState.PlayerReversed = false;}
-  }
-      
-  
-  /* 
-  if(NewInput->Left.EndedDown){
-     // GlobalScrollOffset = max(0, GlobalScrollOffset - SCROLL_SPEED)
-    GlobalScrollOffset = (GlobalScrollOffset - SCROLL_SPEED > 0) ? GlobalScrollOffset - SCROLL_SPEED : 0;
-    GlobalGameMap.XOffset = (int32)GlobalScrollOffset;
-    if(!GlobalPlayerState.PlayerReversed){GlobalPlayerState.PlayerReversed = true;}
-  }
-  else if(NewInput->Right.EndedDown){
-    // GlobalScrollOffset = min(GlobalScrollOffset + SCROLL_SPEED, GlobalGameMap.Width)
-    GlobalScrollOffset = (GlobalScrollOffset + SCROLL_SPEED < GlobalGameMap.Width) ? GlobalScrollOffset + SCROLL_SPEED : GlobalGameMap.Width;
-    GlobalGameMap.XOffset = (int32)GlobalScrollOffset;
-    if(GlobalPlayerState.PlayerReversed){GlobalPlayerState.PlayerReversed = false;}
-  }
-  else{
-    // No Input
-    // (Reset any animation factors)
-    GlobalPlayerState.AnimState = 0;
-    GlobalPlayerState.AnimFrame = 0;
-  }
-  */
+// (Keyboard sampling: game-side handling happens in ProcessGameInput)
+internal void Win64ProcessKeyboardInput(game_input* NewInput){
+  NewInput->Left.EndedDown = (GetAsyncKeyState(VK_LEFT) & 0x8000) != 0;
+  NewInput->Right.EndedDown = (GetAsyncKeyState(VK_RIGHT) & 0x8000) != 0;
 }
 
 // (Gets Current Window Dimensions)
@@ -744,6 +332,46 @@ internal void Win64InitWASAPI(HWND Window){
   sampleRateGlobal = pwfx->nSamplesPerSec;  
 }
 
+// (Per-frame WASAPI fill: writes whatever the endpoint buffer has room for)
+internal void Win64FillSoundBuffer(){
+  TIMED_BLOCK(WASAPI);
+  HRESULT hr;
+  
+  UINT32 currentPaddingFrames;
+  hr = pAudioClientGlobal->GetCurrentPadding(&currentPaddingFrames);
+  if(FAILED(hr)){ OutputDebugStringA("Failed to get current audio frame padding"); }
+  UINT32 currentAvailableFrames = bufferFrameCountGlobal - currentPaddingFrames;
+  
+  if (currentAvailableFrames > 0){
+
+    // Platform-ind. Audio Init
+    // safer size: (48000 < currentAvailableFrames) ? currentAvailableFrames : 48000
+
+    int16* Samples = (int16*)VirtualAlloc(0, currentAvailableFrames * sizeof(int16), MEM_COMMIT, PAGE_READWRITE);
+    game_sound_output_buffer SoundBuffer = {};
+    SoundBuffer.SamplesPerSecond = sampleRateGlobal;
+    SoundBuffer.SampleCount = currentAvailableFrames;
+    SoundBuffer.Samples = Samples;
+
+    // Main Audio + Video Render Call
+    // GameUpdateAndRender(&GameMemory, NewInput, &GraphicalBuffer, &SoundBuffer);
+
+    // Writing Audio to Win64
+    BYTE* pData = NULL; 
+    hr = pRenderClientGlobal->GetBuffer(currentAvailableFrames, &pData);
+    if(FAILED(hr)){ OutputDebugStringA("Failed to get audio buffer"); }
+    for(UINT32 i = 0; i < currentAvailableFrames; ++i){
+      ((float*)pData)[i*2] = SoundBuffer.Samples[i] / 32768.0f; // Left Channel
+      ((float*)pData)[i*2 + 1] = SoundBuffer.Samples[i] / 32768.0f; // Right Channel
+    }
+    pRenderClientGlobal->ReleaseBuffer(currentAvailableFrames, 0);
+      
+  }
+  else{
+    // GameUpdateAndRender(&GameMemory, NewInput, &GraphicalBuffer, NULL);
+  }
+}
+
 // (Widow Resize)
 internal void Win64ResizeDIBSection(win64_offscreen_buffer *Buffer, int Width, int Height){
   if (Buffer->Memory)
@@ -771,71 +399,8 @@ internal void Win64ResizeDIBSection(win64_offscreen_buffer *Buffer, int Width, i
   
 }
 
-internal void LoadLights(){
-  for(int i = 0; i < InternalHeight; ++i){
-    for(int j = 0; j < InternalWidth; ++j){
-      int AdjX = j + GlobalGameMap.XOffset;
-      int TrIndex = OX((InternalHeight - i), AdjX);
-      if((GlobalGLRenderer.Angles[TrIndex] & 0xFF) == 254){
-	  OutputDebugStringA("Trying to add light \n\n\n");
-	  // (add light)
-	  real32 ScreenX = (real32)j;
-	  real32 ScreenY = (real32)(InternalHeight - i);
-	  GlobalLightingSystem.AddLight(ScreenX, ScreenY,
-					1.0f, 0.8f, 0.6f, /* (R, G, B) */
-					2.0f, 100.0f /* (Intensity, Radius) */
-					); // TODO: encode more info into the normal map? e.g. intensity, radius	
-      }
-    }
-  }
-}
-
-// (Load game map into GlobalGLRenderer.Pixels)
-internal void LoadInternalMap(){
-  // 1: Game Map (Column-Major): 
-  for(int i = 0; i < InternalHeight; ++i){
-    for(int j = 0; j < InternalWidth; ++j){
-      int MapJ = j + GlobalGameMap.XOffset;
-      if(MapJ >= 0 && MapJ < GlobalGameMap.Width){
-	int SrcIndex = IX(i,MapJ);
-	int DstIndex = OX((InternalHeight - i), j); // DstIndex = ((InternalHeight - i) * InternalWidth) + (j)
-	GlobalGLRenderer.Pixels[DstIndex] = GlobalGameMap.Pixels[SrcIndex];
-	GlobalGLRenderer.Angles[DstIndex] = GlobalGameMap.Angles[SrcIndex];
-    }}}
-
-  // (dictates frame of animation)
-  int SpriteIndex = GlobalPlayerState.AnimFrame;
-  
-  int SpriteStartY = (SpriteIndex / SpritePitch) * SpriteHeight;
-  int SpriteStartX = (SpriteIndex % SpritePitch) * SpriteWidth;
-
-  // Sprite Rendering
-  for(int i = 0; i < SpriteHeight; ++i){
-    for(int j = 0; j < SpriteWidth; ++j){
-      
-      int SrcIndex = ((SpriteStartY + i) * SpriteMapWidth) + (SpriteStartX + j);
-      if(GlobalSpriteMap.Pixels[SrcIndex] & Alpha != 0){
-
-	int DstIndex;
-	if(!GlobalPlayerState.PlayerReversed){ // Forward
-	  DstIndex = OX(((GlobalPlayerState.BottomOffset + SpriteHeight) - i), (GlobalPlayerState.XOffset + j));
-	}
-	else{ // Reversed
-	  DstIndex = OX(((GlobalPlayerState.BottomOffset + SpriteHeight) - i), ((GlobalPlayerState.XOffset + SpriteWidth) - j));
-	}
-
-	// Foreground (opacity 253 within normal map)
-	if((GlobalGLRenderer.Angles[DstIndex] & 0XFF) != 253){
-	GlobalGLRenderer.Pixels[DstIndex] = GlobalSpriteMap.Pixels[SrcIndex]; }
-	
-      }
-    }
-  }
-  
-}
-
-// (OpenGL Windows Initialization)
-internal void Win64InitOpenGL(HWND Window, HDC WindowDC){
+// (OpenGL Windows Initialization: the context is current on the calling thread until handed to the render thread)
+internal HGLRC Win64InitOpenGL(HWND Window, HDC WindowDC){
   // HDC WindowDC = GetDC(Window); 
   
   PIXELFORMATDESCRIPTOR DesiredPixelFormat = {};
@@ -874,140 +439,14 @@ internal void Win64InitOpenGL(HWND Window, HDC WindowDC){
   */
   
   // ReleaseDC(Window, WindowDC);
+  return OpenGLRC;
 }
 
-// (OpenGL Texturing Init.)
-internal void InitGlobalGLRendering(){
-
-  {/* 1: Shader Loading / Init */}
-  {
-    // (Base shader)
-    GlobalGLRenderer.BaseShader = new Shader("../driver/shader.vert", "../driver/shader.frag");
-    // (Rain shader)
-    GlobalGLRenderer.RainShader = new Shader("../driver/rain.vert", "../driver/rain.frag");
-
-    // CURR TEST:
-    GlobalLightingSystem.ActiveLightCount = 0;
-    /* 
-    GlobalLightingSystem.AddLight(InternalWidth / 2.0f, InternalHeight / 2.0f,
-				  1.0f, .8f, .6f, 1.0f, 100.0f
-				  );
-        GlobalLightingSystem.AddLight(InternalWidth / 4.0f, InternalHeight / 3.0f,
-				  1.0f, .8f, .6f, 5.0f, 200.0f
-				  ); */
-  }
-
-  {/* 2: Base Scene Setup */ }
-  {
-    real32 BaseVertices[] = {
-      // positions        // texture coords
-      -1.0f,  1.0f, 0.0f,  0.0f, 1.0f,
-      1.0f,  1.0f, 0.0f,  1.0f, 1.0f,
-      1.0f, -1.0f, 0.0f,  1.0f, 0.0f,
-      -1.0f, -1.0f, 0.0f,  0.0f, 0.0f
-    };
-        
-    uint32 BaseIndices[] = {
-      0, 1, 2,
-      2, 3, 0    
-    };
-
-    // Generate and bind base VAO/VBO/EBO
-    glGenVertexArrays(1, &GlobalGLRenderer.FrameVAO);
-    glGenBuffers(1, &GlobalGLRenderer.FrameVBO);
-    glGenBuffers(1, &GlobalGLRenderer.FrameEBO);
-        
-    glBindVertexArray(GlobalGLRenderer.FrameVAO);
-        
-    glBindBuffer(GL_ARRAY_BUFFER, GlobalGLRenderer.FrameVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(BaseVertices), BaseVertices, GL_STATIC_DRAW);
-        
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, GlobalGLRenderer.FrameEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(BaseIndices), BaseIndices, GL_STATIC_DRAW);
-        
-    // (Position attribute)
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    // (Texture coords attribute)
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-  }
-  
-  {/* 3: Rain Scene Setup */}
-  {
-    GlobalRainSystem.InitGL();
-    GlobalRainSystem.InitSystem();
-  }
-
-  {/* 4: Texture Setup */}
-  {
-    // (A: Main scene texture)
-    glGenTextures(1, &GlobalGLRenderer.MainTexture);
-    glBindTexture(GL_TEXTURE_2D, GlobalGLRenderer.MainTexture);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST); // (min filter)
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST); // (mag filter)
-
-    // (B: Angle textures)
-    glGenTextures(1, &GlobalGLRenderer.AngleTexture);
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D, GlobalGLRenderer.AngleTexture);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    
-    
-    GlobalGLRenderer.Pixels = (uint32*)VirtualAlloc(0,
-						    sizeof(uint32) * InternalWidth * InternalHeight,
-						    MEM_RESERVE|MEM_COMMIT,
-						    PAGE_READWRITE);
-    GlobalGLRenderer.Angles = (uint32*)VirtualAlloc(0,
-						    sizeof(uint32) * InternalWidth * InternalHeight,
-						    MEM_RESERVE|MEM_COMMIT,
-						    PAGE_READWRITE);
-
-    
-    // (Initialize textures)
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, GlobalGLRenderer.MainTexture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, InternalWidth, InternalHeight, 0,
-                 GL_RGBA, GL_UNSIGNED_INT_8_8_8_8, GlobalGLRenderer.Pixels);
-
-
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D, GlobalGLRenderer.AngleTexture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, InternalWidth, InternalHeight, 0,
-                 GL_RGBA, GL_UNSIGNED_INT_8_8_8_8, GlobalGLRenderer.Angles);
-
-    
-  }
-
-
-  // TODO: does this work as an end?
-  GlobalGLRenderer.BaseShader->Use();
-
-  GlobalGLRenderer.BaseShader->SetFloat("screenWidth", (float)InternalWidth);
-  GlobalGLRenderer.BaseShader->SetFloat("screenHeight", (float)InternalHeight);
-  
-  GlobalGLRenderer.BaseShader->SetInt("gameTexture", 0);
-  GlobalGLRenderer.BaseShader->SetInt("angleTexture", 1);
-  
-  GlobalGLRenderer.RainShader->Use();
-  GlobalGLRenderer.RainShader->SetInt("rainTexture", 0);
-  
-  glEnable(GL_BLEND);
-  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-  CheckGLError("After init global GL");
-
-  // GlobalRainSystem.InitSystem();
-
-  // blue blit (TODO: replace with game screen blit)
-  // for(int i = 0; i < InternalHeight; ++i){for(int j = 0; j < InternalWidth; ++j){ GlobalGLRenderer.Pixels[IX(i,j)] = Alpha|Blue; }}
-  // for(int i = 0; i < 100; ++i){ GlobalGLRenderer.Pixels[IX(i, 100)] = Alpha|Red|Blue;}
-  
-}
-
-// (OpenGL-Based Screen Blitting)
-internal void Win64DisplayBufferInWindow(HDC DeviceContext, int WindowWidth, int WindowHeight, win64_offscreen_buffer *Buffer){
+// (OpenGL-Based Screen Blitting: render thread only)
+// (Blend: see RenderFrameBlend. Pacer: waits out the tick between drawing and presenting, so draw time doesn't
+//  shift the present)
+internal void Win64DisplayBufferInWindow(HDC DeviceContext, int WindowWidth, int WindowHeight, render_frame* Frame, real32 Blend,
+					 frame_pacer* Pacer){
 
   real32 TargetAspectRatio = (real32)InternalWidth / (real32)InternalHeight;
   real32 WindowAspectRatio = (real32)WindowWidth / (real32)WindowHeight;
@@ -1033,43 +472,117 @@ internal void Win64DisplayBufferInWindow(HDC DeviceContext, int WindowWidth, int
   
   {/* Base Texture Pass */}
   {
-    GlobalGLRenderer.BaseShader->Use();
-
-    GlobalLightingSystem.UpdateLightUniforms(GlobalGLRenderer.BaseShader);
-
-    // (A: Bind main texture)
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, GlobalGLRenderer.MainTexture);
-    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, InternalWidth, InternalHeight,
-                    GL_RGBA, GL_UNSIGNED_INT_8_8_8_8, GlobalGLRenderer.Pixels);
-    // (B: Bind angle texture)
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D, GlobalGLRenderer.AngleTexture);
-    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, InternalWidth, InternalHeight,
-                    GL_RGBA, GL_UNSIGNED_INT_8_8_8_8, GlobalGLRenderer.Angles);
-    
-
-    glBindVertexArray(GlobalGLRenderer.FrameVAO);
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-    
+    TIMED_BLOCK(BaseTexturePass);
+    RenderBasePass(Frame, Blend);
   }
   {/* Rain Pass */}
   {
-    GlobalGLRenderer.RainShader->Use();
-    CheckGLError("After shader use");
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, GlobalGLRenderer.RainTexture);
-    CheckGLError("After rain texture bind");
-    glBindVertexArray(GlobalGLRenderer.RainVAO);
-    CheckGLError("After rain VAO bind");
-    glDrawArraysInstanced(GL_TRIANGLE_FAN, 0, 4, GlobalRainSystem.ActiveCount);
-    CheckGLError("After rain draw");
+    TIMED_BLOCK(RainPass);
+    GlobalRainSystem.Draw(&Frame->Rain, Blend, Frame->Draws > 0);
   }
 
   // CheckGLError("After draw");
   
-  SwapBuffers(DeviceContext);
+  {
+    TIMED_BLOCK(RenderWait);
+    FramePacerWait(Pacer);
+  }
+  {
+    TIMED_BLOCK(SwapBuffers);
+    SwapBuffers(DeviceContext);
+  }
+  FramePacerPresented(Pacer);
+  Frame->Draws++;
+
+}
+
+// (Render thread: owns the GL context and presents at GlobalRenderHz, independent of the sim rate: each tick
+//  draws the newest published step (skipping any it was too slow for), blended to when it will be presented,
+//  so simulating step N + 1 overlaps rendering + presenting step N)
+typedef BOOL WINAPI wgl_swap_interval_ext(int Interval);
+struct win64_render_thread{
+  HWND Window;
+  HDC DeviceContext;
+  HGLRC OpenGLRC;
+  volatile int32 Quit;
+  void* Thread;
+
+  // (Render-thread owned: the strategy changes (F5) and reports (F1) are requests it picks up between frames)
+  frame_pacer Pacer;
+  volatile frame_pace_strategy RequestedStrategy;
+  volatile int32 PacingReportRequested;
+  wgl_swap_interval_ext* wglSwapIntervalEXT; // (0: no WGL_EXT_swap_control, vsync unavailable)
+};
+global_variable win64_render_thread GlobalRenderThread;
+
+// (Render thread: switch strategy (swap interval included) and start its stats afresh. Vsync paces to the
+//  display's refresh, so that is its target)
+internal void Win64ApplyPaceStrategy(win64_render_thread* RenderThread, frame_pace_strategy Strategy){
+  if(Strategy == FramePace_VSync && !RenderThread->wglSwapIntervalEXT){
+    Strategy = FramePace_Timer;
+    RenderThread->RequestedStrategy = Strategy;
+  }
+  real64 TargetHz = GlobalRenderHz;
+  if(Strategy == FramePace_VSync){
+    int RefreshHz = GetDeviceCaps(RenderThread->DeviceContext, VREFRESH);
+    if(RefreshHz > 1){ TargetHz = RefreshHz; }
+  }
+  if(RenderThread->wglSwapIntervalEXT){
+    RenderThread->wglSwapIntervalEXT(Strategy == FramePace_VSync ? 1 : 0);
+  }
+  FramePacerReset(&RenderThread->Pacer, Strategy, TargetHz, PlatformGetWallClockSeconds());
+}
+
+internal void Win64RenderThreadProc(void* Data){
+  win64_render_thread* RenderThread = (win64_render_thread*)Data;
+  wglMakeCurrent(RenderThread->DeviceContext, RenderThread->OpenGLRC);
+  RenderThread->wglSwapIntervalEXT = (wgl_swap_interval_ext*)wglGetProcAddress("wglSwapIntervalEXT");
+  Win64ApplyPaceStrategy(RenderThread, RenderThread->RequestedStrategy);
+  while(!RenderThread->Quit){
+    if(RenderThread->RequestedStrategy != RenderThread->Pacer.Strategy){
+      Win64ApplyPaceStrategy(RenderThread, RenderThread->RequestedStrategy);
+    }
+    if(RenderThread->PacingReportRequested){
+      FramePacerReport(&RenderThread->Pacer);
+      ProfileReport(ProfileRing_Render);
+      RenderThread->PacingReportRequested = 0;
+    }
+
+    render_frame* Frame = LatestRenderFrame(&GlobalFrameQueue);
+    if(!Frame){
+      // (Nothing published yet: once frames flow the semaphore is only used to wake us to quit)
+      PlatformWaitSemaphore(GlobalFrameQueue.PublishSemaphore);
+      continue;
+    }
+
+    real32 Blend = RenderFrameBlend(Frame, RenderThread->Pacer.NextDeadline, GlobalSimHz);
+    win64_window_dimension Dimension = GetWindowDimension(RenderThread->Window);
+    ProfileBeginFrame(ProfileRing_Render);
+    Win64DisplayBufferInWindow(RenderThread->DeviceContext, Dimension.Width, Dimension.Height, Frame, Blend,
+			       &RenderThread->Pacer);
+    ProfileEndFrame(ProfileRing_Render);
+  }
+  FramePacerReport(&RenderThread->Pacer);
+  ProfileReport(ProfileRing_Render);
+  wglMakeCurrent(0, 0);
+}
 
+internal void Win64StartRenderThread(HWND Window, HDC DeviceContext, HGLRC OpenGLRC){
+  GlobalRenderThread.Window = Window;
+  GlobalRenderThread.DeviceContext = DeviceContext;
+  GlobalRenderThread.OpenGLRC = OpenGLRC;
+  GlobalRenderThread.Quit = 0;
+  GlobalRenderThread.RequestedStrategy = FramePace_Timer;
+  GlobalFrameQueue.PublishSemaphore = PlatformCreateSemaphore(1 << 30);
+  // (A context is current on one thread at a time)
+  wglMakeCurrent(0, 0);
+  GlobalRenderThread.Thread = PlatformCreateThread(Win64RenderThreadProc, &GlobalRenderThread);
+}
+
+internal void Win64StopRenderThread(){
+  GlobalRenderThread.Quit = 1;
+  PlatformSignalSemaphore(GlobalFrameQueue.PublishSemaphore, 1);
+  PlatformJoinThread(GlobalRenderThread.Thread);
 }
 
 // (Window Procedure)
@@ -1085,6 +598,32 @@ LRESULT Win64MainWindowCallback(HWND Window, UINT Message, WPARAM WParam, LPARAM
       }
     } break;
     
+  case WM_KEYDOWN:
+    {
+      // (F1: dump profiler min/mean/p99 over the last sim frames, and the render thread's pacing stats and
+      //  render-tick profile)
+      if(WParam == VK_F1){
+	GlobalProfileReportRequested = true;
+	GlobalRenderThread.PacingReportRequested = 1;
+      }
+      // (F2: toggle GPU-side scrolling / CPU compositing)
+      else if(WParam == VK_F2){
+	SetRenderMode(GlobalGLRenderer.Mode == RenderMode_GPUScroll ? RenderMode_CPUComposite : RenderMode_GPUScroll);
+      }
+      // (F3: cycle CPU-stepped / stateless GPU / transform feedback rain)
+      else if(WParam == VK_F3){
+	GlobalRainSystem.Mode = (rain_sim_mode)((GlobalRainSystem.Mode + 1) % RainSim_Count);
+      }
+      // (F5: cycle vsync / timer + spin / busy-wait frame pacing (stats restart))
+      else if(WParam == VK_F5){
+	GlobalRenderThread.RequestedStrategy = (frame_pace_strategy)((GlobalRenderThread.Pacer.Strategy + 1) % FramePace_Count);
+      }
+      // (F6: toggle tiled / light-volume lighting)
+      else if(WParam == VK_F6){
+	GlobalLightingSystem.RenderMode = (light_render_mode)((GlobalLightingSystem.RenderMode + 1) % LightRender_Count);
+      }
+    } break;
+    
   case WM_CLOSE:
     {
       GlobalRunning = false;
@@ -1097,12 +636,9 @@ LRESULT Win64MainWindowCallback(HWND Window, UINT Message, WPARAM WParam, LPARAM
     
   case WM_PAINT:
     {
+      // (The render thread redraws every published frame: painting here only validates the region)
       PAINTSTRUCT Paint;
-      HDC DeviceContext = BeginPaint(Window, &Paint);
-
-      win64_window_dimension Dimension = GetWindowDimension(Window);
-      Win64DisplayBufferInWindow(DeviceContext, Dimension.Width, Dimension.Height, &GlobalBackBuffer);
-
+      BeginPaint(Window, &Paint);
       EndPaint(Window, &Paint); // (returns bool)
  
     } break;
@@ -1144,11 +680,11 @@ int WINAPI WinMain(HINSTANCE Instance,
   WindowClass.hInstance = Instance; 
   WindowClass.lpszClassName = "NightWalkWindowClass";
 
-  bool32 SleepIsGranular = (timeBeginPeriod(1) == TIMERR_NOERROR);
+  GlobalSleepIsGranular = (timeBeginPeriod(1) == TIMERR_NOERROR);
 
   LARGE_INTEGER PerfCountFrequencyResult;
   QueryPerformanceFrequency(&PerfCountFrequencyResult);
-  int64 PerfCountFrequency = PerfCountFrequencyResult.QuadPart;
+  GlobalPerfCountFrequency = PerfCountFrequencyResult.QuadPart;
   
   if (RegisterClassA(&WindowClass))
     {
@@ -1169,8 +705,10 @@ int WINAPI WinMain(HINSTANCE Instance,
       if(Window)
 	{
 	  HDC DeviceContext = GetDC(Window);
-	  Win64InitOpenGL(Window, DeviceContext);
-	  InitGlobalGLRendering();
+	  HGLRC OpenGLRC = Win64InitOpenGL(Window, DeviceContext);
+	  // (One job worker per logical core: this thread is worker 0)
+	  JobSystemInit(&GlobalJobSystem, PlatformGetCoreCount());
+	  InitGlobalGLRendering(1);
 	  
 	  // Sound initializations
 	  Win64InitWASAPI(Window);
@@ -1178,43 +716,29 @@ int WINAPI WinMain(HINSTANCE Instance,
 	  int32 SoundBufferSize = 48000 * sizeof(int16) * 2;
 	  int16* Samples = (int16*)VirtualAlloc(0, SoundBufferSize, MEM_RESERVE|MEM_COMMIT, PAGE_READWRITE);
 
-	  // (Game map init.)
-	  int32 GameMapWidth = 720;
-	  int32 GameMapSize = InternalHeight * GameMapWidth * sizeof(uint32);
-	  GlobalGameMap.Pixels = (uint32*)VirtualAlloc(0, GameMapSize, MEM_RESERVE|MEM_COMMIT, PAGE_READWRITE);
-	  GlobalGameMap.Angles = (uint32*)VirtualAlloc(0, GameMapSize, MEM_RESERVE|MEM_COMMIT, PAGE_READWRITE);
-	  // (Sprite map init.)
-	  int32 SpriteMapSize = SpriteMapWidth * SpriteMapHeight * sizeof(uint32);
-	  GlobalSpriteMap.Pixels = (uint32*)VirtualAlloc(0, SpriteMapSize, MEM_RESERVE|MEM_COMMIT, PAGE_READWRITE);
-	  // (Image loading / game map population)
-	  GlobalGameMap.Width = GameMapWidth;
-	  GlobalGameMap.XOffset = 0;
-	  LoadGameMap(&GlobalGameMap, "../media/Scene1.png");
-	  LoadNormalMap(&GlobalGameMap, "../media/NormalMap1.png");
-	  LoadSpriteMap(&GlobalSpriteMap, "../media/Anim1.png");
-
-	  LoadInternalMap();
-	  LoadLights();
+	  // (Game map / sprite map load)
+	  LoadGameScene();
+
+	  // (GL setup is done: from here on only the render thread touches GL)
+	  Win64StartRenderThread(Window, DeviceContext, OpenGLRC);
 	  
 	  game_input Input[2] = {};
 	  game_input* NewInput = &Input[0];
 	  game_input* OldInput = &Input[1];
 	  
 	  // (Performance tracking initializations)
-	  LARGE_INTEGER LastCounter;
-	  QueryPerformanceCounter(&LastCounter);
-	  int64 LastCycleCount =  __rdtsc();
+	  GlobalProfiler.CyclesPerSecond = Win64EstimateCPUTimerFrequency(GlobalPerfCountFrequency);
+
+	  // (Fixed-timestep sim: wall time accumulates, whole 1 / GlobalSimHz steps are taken out of it. Starts one
+	  //  step in so the render thread has a frame right away)
+	  real64 SimStep = 1.0 / GlobalSimHz;
+	  real64 Accumulator = SimStep;
+	  real64 LastTime = PlatformGetWallClockSeconds();
 	  
 	  GlobalRunning = true;	  
 	  while(GlobalRunning){
+	    ProfileBeginFrame(ProfileRing_Sim);
 
-	    // (Base map load)
-	    // if(GlobalGameMap.XOffset != GlobalGameMap.PriorXOffset){
-	      // LoadInternalMap();
-	      // GlobalGameMap.PriorXOffset = GlobalGameMap.XOffset;
-	    // }
-	    LoadInternalMap();
-	 
 	    MSG Message;
 	    
  	    // win64_offscreen_buffer Buffer;
@@ -1226,15 +750,44 @@ int WINAPI WinMain(HINSTANCE Instance,
 	      DispatchMessage(&Message); 
 	    }
 
-	    // Input handling
-	    ProcessGameInput(NewInput, OldInput);
+	    real64 Now = PlatformGetWallClockSeconds();
+	    Accumulator += Now - LastTime;
+	    LastTime = Now;
+	    if(Accumulator > MAX_SIM_STEPS_PER_PASS * SimStep){
+	      // (Stalled (window drag, debugger): the world resumes where it stopped instead of fast-forwarding)
+	      Accumulator = MAX_SIM_STEPS_PER_PASS * SimStep;
+	    }
+
+	    while(Accumulator >= SimStep){
+	      Accumulator -= SimStep;
+
+	      // (Base map load)
+	      // if(GlobalGameMap.XOffset != GlobalGameMap.PriorXOffset){
+		// LoadInternalMap();
+		// GlobalGameMap.PriorXOffset = GlobalGameMap.XOffset;
+	      // }
+	      if(GlobalGLRenderer.Mode == RenderMode_CPUComposite){
+		LoadInternalMap();
+	      }
+
+	      // Input handling
+	      Win64ProcessKeyboardInput(NewInput);
+	      ProcessGameInput(NewInput, OldInput);
+
+	      // (Hand the step to the render thread: it keeps drawing (and blending towards) it while we simulate
+	      //  the next one. Due when the accumulator passed it)
+	      GlobalRainSystem.Update(&SimRenderFrame(&GlobalFrameQueue)->Rain);
+	      BuildRenderFrame(&GlobalFrameQueue, Now - Accumulator);
+	      PublishRenderFrame(&GlobalFrameQueue);
+
+	      game_input* Temp = NewInput;
+	      NewInput = OldInput;
+	      OldInput = Temp;
+	      // TODO: should we clear these here?
+	    }
 
 	    // (Win64 audio padding)
-	    
-	    UINT32 currentPaddingFrames;
-	    hr = pAudioClientGlobal->GetCurrentPadding(&currentPaddingFrames);
-	    if(FAILED(hr)){ OutputDebugStringA("Failed to get current audio frame padding"); }
-	    UINT32 currentAvailableFrames = bufferFrameCountGlobal - currentPaddingFrames;
+	    Win64FillSoundBuffer();
 	    
 	    // Video declarations
 	    
@@ -1243,84 +796,30 @@ int WINAPI WinMain(HINSTANCE Instance,
 	    GraphicalBuffer.Width = GlobalBackBuffer.Width;
 	    GraphicalBuffer.Height = GlobalBackBuffer.Height;
 	    GraphicalBuffer.Pitch = GlobalBackBuffer.Pitch;
-	    
-	    if (currentAvailableFrames > 0){
-
-	      // Platform-ind. Audio Init
-	      // safer size: (48000 < currentAvailableFrames) ? currentAvailableFrames : 48000
-
-	      int16* Samples = (int16*)VirtualAlloc(0, currentAvailableFrames * sizeof(int16), MEM_COMMIT, PAGE_READWRITE);
-	      game_sound_output_buffer SoundBuffer = {};
-	      SoundBuffer.SamplesPerSecond = sampleRateGlobal;
-	      SoundBuffer.SampleCount = currentAvailableFrames;
-	      SoundBuffer.Samples = Samples;
-
-	      // Main Audio + Video Render Call
-	      // GameUpdateAndRender(&GameMemory, NewInput, &GraphicalBuffer, &SoundBuffer);
-
-	      // Writing Audio to Win64
-	      BYTE* pData = NULL; 
-	      hr = pRenderClientGlobal->GetBuffer(currentAvailableFrames, &pData);
-	      if(FAILED(hr)){ OutputDebugStringA("Failed to get audio buffer"); }
-	      for(UINT32 i = 0; i < currentAvailableFrames; ++i){
-		((float*)pData)[i*2] = SoundBuffer.Samples[i] / 32768.0f; // Left Channel
-		((float*)pData)[i*2 + 1] = SoundBuffer.Samples[i] / 32768.0f; // Right Channel
-	      }
-	      pRenderClientGlobal->ReleaseBuffer(currentAvailableFrames, 0);
-	      
-	    }
-	    else{
-	      // GameUpdateAndRender(&GameMemory, NewInput, &GraphicalBuffer, NULL);
-	    }
-
-	    GlobalRainSystem.Update();
-	    win64_window_dimension Dimension = GetWindowDimension(Window);
-	    Win64DisplayBufferInWindow(DeviceContext, Dimension.Width, Dimension.Height, &GlobalBackBuffer);
 	 
 	    //++GlobalXOffset;
 
-	    // Time Tracking (QueryPerformanceCounter, rdtsc): 
-	    LARGE_INTEGER EndCounter;
-	    QueryPerformanceCounter(&EndCounter);	    
-	    
-	    // Sleep until end of frame
-	    real32 SecondsElapsed = Win64GetSecondsElapsed(LastCounter, EndCounter, PerfCountFrequency);
-	    while(SecondsElapsed < TARGET_SECONDS_PER_FRAME){
-	      if(SleepIsGranular){
-		DWORD SleepMS = (DWORD)(1000.0f * (TARGET_SECONDS_PER_FRAME - SecondsElapsed));
-		if(SleepMS > 0){
-		  Sleep(SleepMS);
-		}
-	      }
-	      QueryPerformanceCounter(&EndCounter);
-	      SecondsElapsed = Win64GetSecondsElapsed(LastCounter, EndCounter, PerfCountFrequency);
+	    // Sleep until the next step is due
+	    {
+	      TIMED_BLOCK(FrameWait);
+	      PaceWaitUntil(GlobalRenderThread.RequestedStrategy, Now + (SimStep - Accumulator));
 	    }
 
-	    int64 EndCycleCount = __rdtsc();
-	    int64 CyclesElapsed = EndCycleCount - LastCycleCount;
-	    int64 CounterElapsed = EndCounter.QuadPart - LastCounter.QuadPart;
-	    LastCounter = EndCounter;
-
-	    // (Debugging: )
-	    real32 MSPerFrame = ((real32)(1000.0f * (real32)CounterElapsed) / (real32)PerfCountFrequency);
-	    real32 FPS = (real32)PerfCountFrequency / (real32)CounterElapsed;
-	    real32 MCPF = (real32)CyclesElapsed / (1000.0f * 1000.0f);
-
-	    char Buffer[256];
-	    sprintf(Buffer, "ms / frame: %.02fms --- FPS: %.02ffps --- m-cycles / frame: %.02f\n", MSPerFrame, FPS, MCPF);
-	    OutputDebugStringA(Buffer);
-	    
-
-	    game_input* Temp = NewInput;
-	    NewInput = OldInput;
-	    OldInput = Temp;
-	    // TODO: should we clear these here?
+	    // (Frame timings land in GlobalProfiler's ring: only formatted on request (F1) / at exit)
+	    ProfileEndFrame(ProfileRing_Sim);
+	    if(GlobalProfileReportRequested){
+	      ProfileReport(ProfileRing_Sim);
+	      GlobalProfileReportRequested = false;
+	    }
 
 	    
 	    // (end of while(GlobalRunning loop)
 	  }
 
-	  if(SleepIsGranular){ timeEndPeriod(1); }
+	  Win64StopRenderThread();
+	  UnloadGameScene();
+	  ProfileReport(ProfileRing_Sim);
+	  if(GlobalSleepIsGranular){ timeEndPeriod(1); }
 
 	  hr = pAudioClientGlobal->Stop();
 	  if(FAILED(hr)){ OutputDebugStringA("stopping of audio client failed"); }
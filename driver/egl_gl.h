@@ -0,0 +1,64 @@
+#if !defined(EGL_GL_H)
+
+// (Real OpenGL backend for headless runs (bench.cpp -gl egl): an EGL pbuffer context on Mesa's surfaceless
+//  platform (or the default display), so GL_TIME_ELAPSED queries measure actual GPU work with no window or
+//  display. Like the game's wglCreateContext, no version is asked for: whatever compatibility profile the driver has)
+// (The context is current on the calling thread only)
+
+struct egl_gl{
+  EGLDisplay Display;
+  EGLSurface Surface;
+  EGLContext Context;
+};
+global_variable egl_gl GlobalEGLGL;
+
+// (Returns non-zero with a Width x Height pbuffer current as the default framebuffer and GLAD loaded from it)
+internal int32 EGLGLInit(int32 Width, int32 Height){
+  egl_gl* GL = &GlobalEGLGL;
+  GL->Display = EGL_NO_DISPLAY;
+  const char* ClientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+  PFNEGLGETPLATFORMDISPLAYEXTPROC eglGetPlatformDisplayEXT =
+    (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+  if(eglGetPlatformDisplayEXT && ClientExtensions && strstr(ClientExtensions, "EGL_MESA_platform_surfaceless")){
+    GL->Display = eglGetPlatformDisplayEXT(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, 0);
+  }
+  if(GL->Display == EGL_NO_DISPLAY){ GL->Display = eglGetDisplay(EGL_DEFAULT_DISPLAY); }
+  EGLint Major, Minor;
+  if(GL->Display == EGL_NO_DISPLAY || !eglInitialize(GL->Display, &Major, &Minor)){ return 0; }
+
+  EGLint ConfigAttributes[] = {
+    EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+    EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+    EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+    EGL_NONE
+  };
+  EGLConfig Config;
+  EGLint ConfigCount = 0;
+  if(!eglChooseConfig(GL->Display, ConfigAttributes, &Config, 1, &ConfigCount) || ConfigCount == 0){ return 0; }
+
+  EGLint SurfaceAttributes[] = { EGL_WIDTH, Width, EGL_HEIGHT, Height, EGL_NONE };
+  GL->Surface = eglCreatePbufferSurface(GL->Display, Config, SurfaceAttributes);
+  if(GL->Surface == EGL_NO_SURFACE){ return 0; }
+
+  if(!eglBindAPI(EGL_OPENGL_API)){ return 0; }
+  GL->Context = eglCreateContext(GL->Display, Config, EGL_NO_CONTEXT, 0);
+  if(GL->Context == EGL_NO_CONTEXT){ return 0; }
+  if(!eglMakeCurrent(GL->Display, GL->Surface, GL->Surface, GL->Context)){ return 0; }
+
+  if(!gladLoadGLLoader((GLADloadproc)eglGetProcAddress)){ return 0; }
+  glViewport(0, 0, Width, Height);
+  return 1;
+}
+
+internal void EGLGLShutdown(){
+  egl_gl* GL = &GlobalEGLGL;
+  if(GL->Display == EGL_NO_DISPLAY){ return; }
+  eglMakeCurrent(GL->Display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+  if(GL->Context != EGL_NO_CONTEXT){ eglDestroyContext(GL->Display, GL->Context); }
+  if(GL->Surface != EGL_NO_SURFACE){ eglDestroySurface(GL->Display, GL->Surface); }
+  eglTerminate(GL->Display);
+  *GL = {};
+}
+
+#define EGL_GL_H
+#endif
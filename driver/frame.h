@@ -0,0 +1,123 @@
+#if !defined(FRAME_H)
+
+// (Sim -> render hand-off: everything one rendered frame reads, captured by the sim side once per simulated
+//  frame (BuildRenderFrame) and never touched again by the sim until the render side has let go of it)
+struct render_frame{
+  uint64 SimFrame; // (Simulated frames published before this one)
+  // (Platform clock seconds at which this state is current: over the following step the render side blends
+  //  from the previous step's state (Prev*) towards it (see RenderFrameBlend))
+  real64 DueTime;
+  uint32 Draws; // (Render side: times drawn so far: a frame held across render ticks uploads only on the first)
+  render_mode Mode;
+
+  // (RenderMode_GPUScroll: camera + player sprite)
+  int32 MapXOffset, PrevMapXOffset;
+  int32 SpriteX, SpriteY; // (Screen position: player XOffset, BottomOffset)
+  int32 PrevSpriteX;
+  int32 SpriteIndex; // (Frame within the sprite sheet)
+  bool32 SpriteReversed;
+
+  // (Map chunks newly resident (world.h), for the GPU ring: ChunkUploadCount of them, texels back to back)
+  int32 ChunkUploadCount;
+  int32 ChunkUploads[WORLD_MAX_CHUNK_UPLOADS];
+  uint32* ChunkPixels;
+  uint32* ChunkAngles;
+
+  // (RenderMode_CPUComposite: screen rect to re-upload; Pixels / Angles are screen-sized, valid inside it only)
+  bool32 ScreenDirty;
+  int32 DirtyRow0, DirtyRow1;
+  int32 DirtyCol0, DirtyCol1;
+  uint32* Pixels;
+  uint32* Angles;
+
+  // (Slots keep their copy between uses: only a newer block is copied in (see BuildRenderFrame))
+  lighting_system::light_uniform_block Lights;
+  uint32* LightTiles; // (lighting_system::MAX_TILE_ENTRIES, LightTileCount of them valid)
+  uint32 LightTileCount;
+  uint32 LightVersion;
+  light_render_mode LightMode;
+
+  rain_frame Rain;
+};
+
+// (Lock-free triple buffer: the sim fills Back while the render side draws Front; Middle holds the newest
+//  published frame. Publishing swaps Back <-> Middle, acquiring swaps Middle <-> Front, each one atomic
+//  exchange, so neither side ever waits on the other: a sim that runs ahead just replaces unread frames)
+#define RENDER_FRAME_FRESH 4 // (Set on Middle between a publish and the next acquire)
+struct render_frame_queue{
+  render_frame Frames[3];
+  volatile int32 Middle; // (Slot index | RENDER_FRAME_FRESH)
+  int32 Back; // (Sim-owned)
+  int32 Front; // (Render-owned)
+  bool32 FrontValid; // (Render-owned: Front holds a published frame)
+  uint64 Published;
+  int32 LastMapXOffset, LastSpriteX; // (Sim-owned: the previous frame's camera / sprite, where the next one blends from)
+
+  // (Render thread, if any, sleeps here between frames: 0 when the sim renders inline)
+  void* PublishSemaphore;
+};
+global_variable render_frame_queue GlobalFrameQueue;
+
+internal void InitRenderFrameQueue(render_frame_queue* Queue){
+  for(int32 i = 0; i < 3; ++i){
+    Queue->Frames[i].Pixels = (uint32*)PlatformAllocateMemory(sizeof(uint32) * InternalWidth * InternalHeight);
+    Queue->Frames[i].Angles = (uint32*)PlatformAllocateMemory(sizeof(uint32) * InternalWidth * InternalHeight);
+    Queue->Frames[i].LightTiles = (uint32*)PlatformAllocateMemory(sizeof(uint32) * lighting_system::MAX_TILE_ENTRIES);
+    Queue->Frames[i].ChunkPixels = (uint32*)PlatformAllocateMemory(sizeof(uint32) * WorldChunkTexels * WORLD_MAX_CHUNK_UPLOADS);
+    Queue->Frames[i].ChunkAngles = (uint32*)PlatformAllocateMemory(sizeof(uint32) * WorldChunkTexels * WORLD_MAX_CHUNK_UPLOADS);
+  }
+  Queue->Back = 0;
+  Queue->Middle = 1;
+  Queue->Front = 2;
+  Queue->FrontValid = false;
+  Queue->Published = 0;
+  Queue->PublishSemaphore = 0;
+}
+
+// (Sim side: the slot to fill this frame)
+inline render_frame* SimRenderFrame(render_frame_queue* Queue){
+  return &Queue->Frames[Queue->Back];
+}
+
+// (Sim side: the last published frame if the render side hasn't taken it yet (it may still do so at any moment:
+//  read-only, and only to widen what the next frame carries))
+inline render_frame* UnreadRenderFrame(render_frame_queue* Queue){
+  int32 Middle = Queue->Middle;
+  return (Middle & RENDER_FRAME_FRESH) ? &Queue->Frames[Middle & 3] : 0;
+}
+
+internal void PublishRenderFrame(render_frame_queue* Queue){
+  Queue->Frames[Queue->Back].SimFrame = Queue->Published++;
+  int32 Previous = AtomicExchangeI32(&Queue->Middle, Queue->Back | RENDER_FRAME_FRESH);
+  Queue->Back = Previous & 3;
+  if(Queue->PublishSemaphore){ PlatformSignalSemaphore(Queue->PublishSemaphore, 1); }
+}
+
+// (Render side: the newest frame published since the last call, or 0 if there is none)
+internal render_frame* AcquireRenderFrame(render_frame_queue* Queue){
+  if(!(Queue->Middle & RENDER_FRAME_FRESH)){ return 0; }
+  int32 Previous = AtomicExchangeI32(&Queue->Middle, Queue->Front);
+  Queue->Front = Previous & 3;
+  Queue->FrontValid = true;
+  return &Queue->Frames[Queue->Front];
+}
+
+// (Render side: the newest published frame, or the one already held if nothing newer arrived (rendering
+//  faster than the sim redraws it, further blended); 0 before the first publish)
+internal render_frame* LatestRenderFrame(render_frame_queue* Queue){
+  render_frame* Frame = AcquireRenderFrame(Queue);
+  if(!Frame && Queue->FrontValid){ Frame = &Queue->Frames[Queue->Front]; }
+  return Frame;
+}
+
+// (Render side: how far into the step after Frame's to draw, [0, 1]: 0 is the previous state, 1 Frame's own.
+//  Now runs one step behind the sim, so a render tick always falls between two states it already has)
+inline real32 RenderFrameBlend(render_frame* Frame, real64 Now, real64 SimHz){
+  real64 Blend = (Now - Frame->DueTime) * SimHz;
+  if(Blend < 0.0){ Blend = 0.0; }
+  if(Blend > 1.0){ Blend = 1.0; } // (Sim late: hold the newest state rather than extrapolate)
+  return (real32)Blend;
+}
+
+#define FRAME_H
+#endif
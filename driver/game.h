@@ -0,0 +1,1219 @@
+#if !defined(GAME_H)
+
+// INCLUDES / DEFINES
+
+#include <stdint.h> // (included by default with GLAD)
+#include <stddef.h>
+#include <glad/glad.h>
+
+#include <stdlib.h> // (qsort: profiler.h)
+#include <math.h> // TODO: examine math implementations, see if we can hand-make? (e.g. sin)
+#include <stdio.h> // (for temporary debugging (sprintf for performance tracking))
+#include <string.h> // (memcpy)
+#include <emmintrin.h> // (SSE2: rain kernel, particle RNG)
+
+#define global_variable static
+#define internal static
+
+typedef uint8_t uint8;
+typedef uint16_t uint16;
+typedef uint32_t uint32;
+typedef uint64_t uint64;
+
+typedef int16_t int16;
+typedef int32_t int32;
+typedef int64_t int64;
+
+typedef float real32;
+typedef double real64;
+
+typedef int32_t bool32;
+
+// (Used in particle structs)
+// (Resolution Width, Height)
+global_variable const uint32 InternalWidth = 320;
+global_variable const uint32 InternalHeight = 180;
+
+// (Internal Display)
+// (OpenGL translation: row-major)
+#define OX(i,j) (((i)*InternalWidth)+(j))
+// (Map row i lands on GL row (InternalHeight - 1 - i): the texture is bottom-up)
+#define ScreenRowFromMapRow(i) ((InternalHeight - 1) - (i))
+// (Game map translation: row-major over a whole map in memory (the PNG scene, FullWidth wide), rows already in
+//  GL order (see media.h). Once loaded, the map is read through its resident chunks instead (world.h))
+#define MX(i,j) (((i)*FullWidth)+(j))
+#define ArrayCount(arr) (sizeof(arr) / sizeof(arr[0]))
+
+// TODO: refactor for differently-sized sprites
+global_variable const uint32 SpriteWidth = 15;
+global_variable const uint32 SpriteHeight = 20;
+global_variable const uint32 SpritePitch = 10; // (Probably won't have to use)
+global_variable const uint32 SpriteMapWidth = 75;
+global_variable const uint32 SpriteMapHeight = 20;
+
+// [(i % SpritePitch) * SpriteWidth, (i / SpritePitch) * SpriteHeight]
+// #define SpritePosition(i) OX((),())
+// #define SpritePosition(i) [(((i)%SpritePitch) * SpriteWidth), (((i)/SpritePitch)*SpriteHeight)]
+
+// (Full Width of the PNG scene: used in media.h. Packed worlds carry their own width (pack.h))
+global_variable const uint32 FullWidth = 720;
+// (Used for error checking in raindrop struct functions)
+internal void CheckGLError(char* label);
+
+// PLATFORM SERVICES
+// (Implemented by each platform layer: driver.cpp (Win64), bench.cpp (headless))
+struct ProcessedFile{
+  void* Contents;
+  uint32 ContentsSize; 
+};
+
+internal void PlatformOutputDebugString(char* Message);
+internal void* PlatformAllocateMemory(size_t Size);
+internal void PlatformFreeMemory(void* Memory);
+internal ProcessedFile PlatformReadEntireFile(char* Filename);
+// (Whole-file view, copy-on-write: pages load on first touch, writes stay private to the process)
+struct mapped_file{
+  void* Memory;
+  uint64 Size;
+};
+internal mapped_file PlatformMapFile(char* Filename); // (Memory = 0 on failure)
+internal void PlatformUnmapFile(mapped_file* File);
+// (Random-access reads of a file kept open: the world streamer (world.h) pulls chunks through it)
+internal void* PlatformOpenFileForReading(char* Filename); // (0 on failure)
+internal bool32 PlatformReadFileAt(void* File, uint64 Offset, void* Dest, uint32 Size);
+internal void PlatformCloseFile(void* File);
+
+// (Threads + wakeups for the job system (jobs.h))
+typedef void platform_thread_proc(void* Data);
+internal void* PlatformCreateThread(platform_thread_proc* Proc, void* Data);
+internal void PlatformJoinThread(void* Thread);
+internal void* PlatformCreateSemaphore(uint32 MaxCount);
+internal void PlatformDestroySemaphore(void* Semaphore);
+internal void PlatformSignalSemaphore(void* Semaphore, uint32 Count);
+internal void PlatformWaitSemaphore(void* Semaphore);
+internal uint32 PlatformGetCoreCount(); // (Logical processors)
+
+// (Clocks + waits for fixed-timestep / frame pacing (pacer.h))
+internal real64 PlatformGetWallClockSeconds(); // (Monotonic, high resolution)
+internal real64 PlatformGetThreadCPUSeconds(); // (CPU time the calling thread has used)
+internal void PlatformTimerWait(real64 Seconds); // (Sleep on the finest timer available: may wake late)
+
+#include "jobs.h"
+#include "profiler.h"
+#include "pacer.h"
+#include "random.h"
+
+// (lighting_system pool handle (see lighting.h): stays valid until the light is removed)
+struct light_handle{
+  uint32 Slot;
+  uint32 Generation;
+};
+
+// (Light source baked into the normal map (alpha 254), indexed once per map by IndexLightEmitters)
+struct light_emitter{
+  int32 MapX;
+  int32 Row; // (GL row order, as Angles)
+  real32 R, G, B;
+  real32 Intensity, Radius;
+  light_handle Light; // (Lit while in the streamed range)
+};
+
+struct game_map{
+  mapped_file Pack; // (Loaded from a scene pack (pack.h): Emitters point into it)
+  // (Chunk source (world.h): the pack's map sections, read through PackFile, else the whole map in memory)
+  void* PackFile;
+  uint64 PackPixelsOffset, PackAnglesOffset;
+  uint32* Pixels; // (PNG scenes only: 0 when streamed from a pack)
+  uint32* Angles; // (Normal map, decoded at load: RG = surface normal, A = material flags (DecodeNormalTexel))
+  int32 NormalDecode; // (normal_decode (media.h) Angles was written with: packs always hold NormalDecode_Load)
+  int32 Width;
+  int32 ChunkCount; // (WorldChunkCount(Width))
+  // (Height = InternalHeight)
+  int32 XOffset;
+  // int32 PlayerOffset; // (dictates where we draw sprite)
+
+  // (Whole-map emitter index, sorted by MapX: StreamMapLights range-queries it as XOffset moves)
+  light_emitter* Emitters;
+  int32 EmitterCount;
+  real32 MaxEmitterRadius;
+  // (Emitters [StreamedFirst, StreamedLast) are lit, placed for StreamedXOffset)
+  int32 StreamedFirst, StreamedLast;
+  int32 StreamedXOffset;
+};
+global_variable game_map GlobalGameMap;
+
+
+struct sprite_map{
+  uint32* Pixels;
+  // int32 MapWidth;
+  // int32 MapHeight;
+};
+global_variable sprite_map GlobalSpriteMap;
+
+
+// STRUCTS
+#include "shader.h"
+// (Window structs)
+/*
+struct player_anim{
+int32 StartFrame; // (first frame of animation)
+int32 EndFrame; // (last frame of animatioN)
+int32 Direction; // (is it reversed?)
+}
+ */
+struct player_state{
+  // General State: 
+  int32 AnimState = 0; // 0 = Idle, 1 = Walk
+  bool32 PlayerReversed = false;
+
+  // Animation Metadata: 
+  int32 AnimFrame = 0; // Sprite within animation
+  int32 AnimInter = 0; // Interval frame within current sprite panel
+  real32 AnimInterval = 0.2f; // (Seconds per sprite panel)
+
+  // (Animation Tags:)
+  int32 WalkStart = 1;
+  int32 WalkEnd = 5;
+  int32 WalkDirection = 1; // (Status within ping-pong animation)
+
+  real32 MovementSpeed = 30.0f; // (Pixels per second)
+  real64 MovementRemainder = 0.0; // (Sub-pixel movement carried into the next step)
+  int32 LocalXOffset = 25;
+  int32 XOffset = 10;
+  int32 BottomOffset = 27;
+  
+};
+global_variable player_state GlobalPlayerState;
+
+// (How the base pass gets its background)
+enum render_mode{
+  RenderMode_GPUScroll, // (Full map + sprite sheet resident on the GPU: camera / sprite state sent as uniforms)
+  RenderMode_CPUComposite, // (LoadInternalMap composes the visible window on the CPU, re-uploaded when it changes)
+};
+
+// (Pixel-unpack buffers per screen texture: uploads rotate through them so a new frame never waits on the last one)
+global_variable const uint32 ScreenPBOCount = 3;
+
+struct GLBuffer {
+  render_mode Mode;
+
+  // (Base rendering resources)
+  GLuint MainTexture;
+  GLuint FrameVAO;
+  GLuint FrameVBO;
+  GLuint FrameEBO;
+  Shader* BaseShader;
+  uint32* Pixels;
+
+  // (Normal map resources)
+  GLuint AngleTexture;
+  uint32* Angles;
+
+  // (RenderMode_CPUComposite upload ring)
+  GLuint PixelPBOs[ScreenPBOCount];
+  GLuint AnglePBOs[ScreenPBOCount];
+  uint32 ScreenPBOIndex;
+
+  // (RenderMode_GPUScroll: the map textures are a ring of the resident chunks (world.h), filled at scene load
+  //  (UploadResidentSceneTextures) and then chunk by chunk as render frames bring them; the sprite sheet is
+  //  uploaded once per scene)
+  GLuint MapTexture;
+  GLuint MapAngleTexture;
+  GLuint SpriteTexture;
+  int32 MapWidth; // (World columns: the shader clamps to it before wrapping into the ring)
+  GLint MapXOffsetLocation;
+  GLint LightShiftXLocation;
+  GLint NormalDecodeLocation;
+  GLint MapWidthLocation;
+  GLint SpritePositionLocation;
+  GLint SpriteSheetOriginLocation;
+  GLint SpriteReversedLocation;
+  GLint LightPassLocation;
+  
+  // (Rain rendering)
+  GLuint RainVAO;
+  GLuint RainVBO; // (single-raindrop vertex data)
+  GLuint RainInstanceVBO; // (data for instances)
+  GLuint RainTexture;
+  Shader* RainShader;
+  // (Stateless rain: static spawn instances, see rain_stateless.vert)
+  GLuint RainStatelessVAO;
+  GLuint RainSpawnVBO;
+  Shader* RainStatelessShader;
+  // (Transform feedback rain: ping-pong state buffers, see rain_update.vert)
+  GLuint RainFeedbackVBOs[2];
+  GLuint RainFeedbackUpdateVAOs[2];
+  GLuint RainFeedbackDrawVAOs[2];
+  Shader* RainUpdateShader;
+};
+global_variable GLBuffer GlobalGLRenderer;
+// (I like putting image.h here, shader.h should also be fine?)
+
+#include "lighting.h"
+
+
+#include "media.h"
+#include "world.h"
+#include "pack.h"
+
+// (Internal game metadata for window blitting)
+struct game_offscreen_buffer
+{
+  int Width;
+  int Height;
+  int Pitch;
+  void *Memory;
+}; 
+
+// (Input structs)
+struct game_button_state {
+  // int HalfTransitionCount;
+  bool EndedDown;
+};
+struct game_input {  
+  union{
+    game_button_state Buttons[2];
+    struct{
+      // game_button_state Up;
+      // game_button_state Down;
+      game_button_state Left;
+      game_button_state Right;
+      // game_button_state LeftShoulder;
+      // game_button_state RightShoulder;
+    };
+  };
+  
+};
+
+// (Sound structs)
+struct game_sound_output_buffer
+{
+  int SamplesPerSecond;
+  int16 SampleCount;
+  int16 *Samples;
+};
+
+// Framerate Control
+// (The sim advances in fixed 1 / GlobalSimHz steps (player / rain speeds are per second, turned into per-step
+//  moves); rendering runs at GlobalRenderHz independently, blending camera and rain between the last two steps)
+global_variable real64 GlobalSimHz = 30.0;
+global_variable real64 GlobalRenderHz = 144.0;
+// (Steps one pass of the platform loop may run to catch up after a stall: older backlog is dropped, so a
+//  slow frame can't snowball into ever longer ones)
+global_variable const uint32 MAX_SIM_STEPS_PER_PASS = 5;
+
+#include "rain.h"
+#include "frame.h"
+
+// (GLOBALS)
+
+// (Colors)
+global_variable const uint32 Red = (0xFF << 24);
+global_variable const uint32 Green = (0xFF << 16);
+global_variable const uint32 Blue = (0xFF << 8);
+global_variable const uint32 Alpha = 0XFF;
+
+// (Scroll speed)
+// global_variable const real32 SCROLL_SPEED = 1.0f;
+global_variable real32 GlobalScrollOffset = 0;
+
+// GAME FUNCTIONS
+
+// (OpenGL Error Checking))
+internal void CheckGLError(char* label){
+  GLenum err;
+  while((err = glGetError()) != GL_NO_ERROR) {
+    char errorMsg[256];
+    sprintf(errorMsg, "OpenGL error at %s: 0x%x\n", label, err);
+    PlatformOutputDebugString(errorMsg);
+  }
+}
+
+// (NewInput's buttons are sampled by the platform layer before this call)
+internal void ProcessGameInput(game_input* NewInput, game_input* OldInput){
+  TIMED_BLOCK(ProcessGameInput);
+
+  // OutputDebugStringA(NewInput->Left.EndedDown ? "Left key DOWN\n" : "Left key UP\n");
+  // NewInput->Right.EndedDown = true;
+
+  // Handle conflicting input:
+  if(NewInput->Left.EndedDown && NewInput->Right.EndedDown){
+    if(OldInput->Right.EndedDown && !OldInput->Left.EndedDown){
+      // Prioritize new left input
+      NewInput->Right.EndedDown = false; 
+    }
+    else{
+      NewInput->Left.EndedDown = false;
+    }
+    {
+    /* if(OldInput->Left.EndedDown && !OldInput->Right.EndedDown){
+      // Prioritize new right input
+      NewInput->Left.EndedDown = false;
+    }
+    else if(OldInput->RightEndedDown && !OldInput.LeftEndedDown){
+      // Prioritize new left input
+      NewInput->Right.EndedDown = false; 
+      } */
+    }
+  }
+
+  // Animation State Handling: 
+  if(GlobalPlayerState.AnimState == 0){
+    // Prior State: Idle
+
+    if(NewInput->Left.EndedDown || NewInput->Right.EndedDown){
+      GlobalPlayerState.AnimState = 1; // (Anim State: Walking)
+      GlobalPlayerState.AnimFrame = GlobalPlayerState.WalkStart;
+    }
+    else{ /* (Remain Idle) */}
+
+  }
+  else if(GlobalPlayerState.AnimState == 1){
+    // Prior State: Walking
+
+    if(NewInput->Left.EndedDown || NewInput->Right.EndedDown){
+      
+      GlobalPlayerState.AnimInter++;
+
+      // (Steps per panel at the current sim rate)
+      int32 MaxAnimInter = (int32)((GlobalPlayerState.AnimInterval * GlobalSimHz) + 0.5);
+      if(MaxAnimInter < 1){ MaxAnimInter = 1; }
+      if(GlobalPlayerState.AnimInter >= MaxAnimInter){
+	GlobalPlayerState.AnimInter = 0;
+	GlobalPlayerState.AnimFrame += GlobalPlayerState.WalkDirection;
+
+	// (Change walk direction if we reach an animation bound)
+	if(GlobalPlayerState.AnimFrame == GlobalPlayerState.WalkStart){ GlobalPlayerState.WalkDirection = 1; }
+	else if(GlobalPlayerState.AnimFrame == GlobalPlayerState.WalkEnd){ GlobalPlayerState.WalkDirection = -1; }
+      }
+    }
+    else{
+      // Reset animation metadata
+      GlobalPlayerState.AnimState = 0; // (Anim State: Idle)
+      GlobalPlayerState.AnimFrame = 0; // (Idle Frame)
+      // (Reset walking-specific metadata:)
+      GlobalPlayerState.AnimInter = 0;
+      GlobalPlayerState.WalkDirection = 1;
+    }
+  }
+
+  // Irrespective Handling: Player Movement
+  // (Whole pixels this step: the fraction carries over while walking, so the speed holds at any sim rate)
+  int32 MovementStep = 0;
+  if(NewInput->Left.EndedDown || NewInput->Right.EndedDown){
+    real64 Movement = (GlobalPlayerState.MovementSpeed / GlobalSimHz) + GlobalPlayerState.MovementRemainder;
+    MovementStep = (int32)Movement;
+    GlobalPlayerState.MovementRemainder = Movement - MovementStep;
+  }
+  else{ GlobalPlayerState.MovementRemainder = 0.0; }
+  // (Signed: the unsigned InternalWidth would otherwise turn the XOffset comparisons below unsigned)
+  int32 MaxMapXOffset = GlobalGameMap.Width - (int32)InternalWidth;
+
+  if(NewInput->Left.EndedDown){
+    if(GlobalGameMap.XOffset == 0){ // Leftmost region
+      // GlobalPlayerState.XOffset = max(GlobalPlayerState.XOffset - MovementStep, 0)
+      GlobalPlayerState.XOffset = GlobalPlayerState.XOffset - MovementStep < 0 ?
+	0 : GlobalPlayerState.XOffset - MovementStep;
+    }
+    else if(GlobalGameMap.XOffset == MaxMapXOffset && GlobalPlayerState.XOffset > GlobalPlayerState.LocalXOffset){ // Rightmost region
+      // GlobalPlayerState.XOffset = max(GlobalPlayerState.XOffset - MovementStep, GlobalPlayerState.LocalXOffset)
+      GlobalPlayerState.XOffset = GlobalPlayerState.XOffset - MovementStep < GlobalPlayerState.LocalXOffset ?
+	GlobalPlayerState.LocalXOffset : GlobalPlayerState.XOffset - MovementStep;
+    }
+    else{
+      // GlobalGameMap.XOffset = max(GlobalGameMap.XOffset - MovementStep, 0)
+      GlobalGameMap.XOffset = GlobalGameMap.XOffset - MovementStep < 0 ?
+	0 : GlobalGameMap.XOffset - MovementStep;     
+    }
+      
+    if(!GlobalPlayerState.PlayerReversed){GlobalPlayerState.PlayerReversed = true;}
+  }
+  
+  if(NewInput->Right.EndedDown){
+
+    if(GlobalPlayerState.XOffset < GlobalPlayerState.LocalXOffset){
+      // (Move player within left region)
+      // GlobalPlayerState.XOffset = min(GlobalPlayerState.LocalXOffset, GlobalPlayerState.XOffset + MovementStep)
+      GlobalPlayerState.XOffset = GlobalPlayerState.XOffset + MovementStep > GlobalPlayerState.LocalXOffset ?
+	GlobalPlayerState.LocalXOffset : GlobalPlayerState.XOffset + MovementStep;
+    }
+    else if(GlobalGameMap.XOffset == MaxMapXOffset){
+      // (Move player within right region)
+      // GlobalPlayerState.XOffset = min(GlobalPlayerState.XOffset + SCROLL_SPEED, (InternalWidth - SpriteWidth))
+      int32 AdjustedWidth = InternalWidth - SpriteWidth;
+      GlobalPlayerState.XOffset = GlobalPlayerState.XOffset + MovementStep > AdjustedWidth ?
+	AdjustedWidth : GlobalPlayerState.XOffset + MovementStep;
+    }
+    else{
+      // Move screen
+      // GlobalGameMap.XOffset = min(GlobalGameMap.XOffset + MovementStep, MaxMapXOffset)
+      GlobalGameMap.XOffset = GlobalGameMap.XOffset + MovementStep > MaxMapXOffset ?
+	MaxMapXOffset : GlobalGameMap.XOffset + MovementStep;
+      
+    }
+    
+    if(GlobalPlayerState.PlayerReversed){GlobalPlayerState.PlayerReversed = false;}
+  }
+      
+  
+  /* 
+  if(NewInput->Left.EndedDown){
+     // GlobalScrollOffset = max(0, GlobalScrollOffset - SCROLL_SPEED)
+    GlobalScrollOffset = (GlobalScrollOffset - SCROLL_SPEED > 0) ? GlobalScrollOffset - SCROLL_SPEED : 0;
+    GlobalGameMap.XOffset = (int32)GlobalScrollOffset;
+    if(!GlobalPlayerState.PlayerReversed){GlobalPlayerState.PlayerReversed = true;}
+  }
+  else if(NewInput->Right.EndedDown){
+    // GlobalScrollOffset = min(GlobalScrollOffset + SCROLL_SPEED, GlobalGameMap.Width)
+    GlobalScrollOffset = (GlobalScrollOffset + SCROLL_SPEED < GlobalGameMap.Width) ? GlobalScrollOffset + SCROLL_SPEED : GlobalGameMap.Width;
+    GlobalGameMap.XOffset = (int32)GlobalScrollOffset;
+    if(GlobalPlayerState.PlayerReversed){GlobalPlayerState.PlayerReversed = false;}
+  }
+  else{
+    // No Input
+    // (Reset any animation factors)
+    GlobalPlayerState.AnimState = 0;
+    GlobalPlayerState.AnimFrame = 0;
+  }
+  */
+}
+
+// (Scan the whole map's normal map once for emitters: column by column, so the index comes out sorted by MapX)
+internal void IndexLightEmitters(game_map* GameMap){
+  int32 Count = 0;
+  for(int32 Pass = 0; Pass < 2; ++Pass){
+    for(int32 X = 0; X < GameMap->Width; ++X){
+      for(int32 Row = 0; Row < InternalHeight; ++Row){
+	if((GameMap->Angles[MX(Row, X)] & 0xFF) != 254){ continue; }
+	if(Pass == 1){
+	  light_emitter* Emitter = &GameMap->Emitters[Count];
+	  Emitter->MapX = X;
+	  Emitter->Row = Row;
+	  Emitter->R = 1.0f; Emitter->G = 0.8f; Emitter->B = 0.6f;
+	  Emitter->Intensity = 2.0f;
+	  Emitter->Radius = 100.0f; // TODO: encode more info into the normal map? e.g. intensity, radius
+	  if(Emitter->Radius > GameMap->MaxEmitterRadius){ GameMap->MaxEmitterRadius = Emitter->Radius; }
+	}
+	++Count;
+      }
+    }
+    if(Pass == 0){
+      if(GameMap->Emitters){
+	for(int32 i = GameMap->StreamedFirst; i < GameMap->StreamedLast; ++i){
+	  GlobalLightingSystem.RemoveLight(GameMap->Emitters[i].Light);
+	}
+	PlatformFreeMemory(GameMap->Emitters);
+      }
+      GameMap->Emitters = Count ? (light_emitter*)PlatformAllocateMemory(sizeof(light_emitter) * Count) : 0;
+      GameMap->EmitterCount = Count;
+      GameMap->MaxEmitterRadius = 0.0f;
+      Count = 0;
+    }
+  }
+  // (Nothing streamed yet: the next StreamMapLights places everything in view)
+  GameMap->StreamedFirst = GameMap->StreamedLast = 0;
+  GameMap->StreamedXOffset = -1;
+}
+
+// (Index of the first emitter at MapX or beyond (EmitterCount if none): binary search)
+internal int32 FirstEmitterFrom(game_map* GameMap, int32 MapX){
+  int32 Low = 0;
+  int32 High = GameMap->EmitterCount;
+  while(Low < High){
+    int32 Middle = Low + ((High - Low) / 2);
+    if(GameMap->Emitters[Middle].MapX < MapX){ Low = Middle + 1; }
+    else{ High = Middle; }
+  }
+  return Low;
+}
+
+// (Sim side, once per step before the light block is rebuilt: light the emitters whose radius can reach the
+//  view window at the current XOffset, O(log n + k). Emitters leaving the range are retired, entering ones
+//  activated; lights are in screen space, so a scroll re-places the k lit ones. Nothing happens while
+//  neither the window nor the set moves)
+internal void StreamMapLights(game_map* GameMap){
+  TIMED_BLOCK(StreamLights);
+  // (Plus the cull margin: the render side may draw the lights that much off the step's camera)
+  int32 Margin = (int32)ceilf(GameMap->MaxEmitterRadius + GlobalLightingSystem.CullMarginX);
+  int32 First = FirstEmitterFrom(GameMap, GameMap->XOffset - Margin);
+  int32 Last = FirstEmitterFrom(GameMap, GameMap->XOffset + (int32)InternalWidth + Margin);
+  if(First == GameMap->StreamedFirst && Last == GameMap->StreamedLast && GameMap->XOffset == GameMap->StreamedXOffset){
+    return;
+  }
+
+  // (Old range minus the new one)
+  for(int32 i = GameMap->StreamedFirst; i < GameMap->StreamedLast; ++i){
+    if(i >= First && i < Last){ continue; }
+    GlobalLightingSystem.RemoveLight(GameMap->Emitters[i].Light);
+  }
+  for(int32 i = First; i < Last; ++i){
+    light_emitter* Emitter = &GameMap->Emitters[i];
+    real32 ScreenX = (real32)(Emitter->MapX - GameMap->XOffset);
+    if(GlobalLightingSystem.GetLight(Emitter->Light)){
+      GlobalLightingSystem.MoveLight(Emitter->Light, ScreenX, (real32)Emitter->Row);
+    }
+    else{
+      Emitter->Light = GlobalLightingSystem.AddLight(ScreenX, (real32)Emitter->Row,
+						     Emitter->R, Emitter->G, Emitter->B, Emitter->Intensity, Emitter->Radius);
+    }
+  }
+  GameMap->StreamedFirst = First;
+  GameMap->StreamedLast = Last;
+  GameMap->StreamedXOffset = GameMap->XOffset;
+}
+
+// (Incremental compositor: what is currently composed into GlobalGLRenderer.Pixels / Angles)
+struct compositor_state{
+  bool32 Valid; // (false -> next LoadInternalMap recomposes everything)
+  bool32 TexturesDirty; // (Pixels / Angles changed since the last render frame was built: cleared by BuildRenderFrame)
+  // (Screen rect changed since the last upload: [DirtyRow0, DirtyRow1) x [DirtyCol0, DirtyCol1))
+  int32 DirtyRow0, DirtyRow1;
+  int32 DirtyCol0, DirtyCol1;
+  int32 XOffset;
+  int32 AnimFrame;
+  bool32 PlayerReversed;
+  int32 PlayerXOffset;
+  int32 PlayerBottomOffset;
+};
+global_variable compositor_state GlobalCompositor;
+
+// (Grow the pending upload rect; already clipped to the screen)
+internal void MarkScreenDirty(int32 Row0, int32 Row1, int32 Col0, int32 Col1){
+  compositor_state* State = &GlobalCompositor;
+  if(!State->TexturesDirty){
+    State->DirtyRow0 = Row0; State->DirtyRow1 = Row1;
+    State->DirtyCol0 = Col0; State->DirtyCol1 = Col1;
+    State->TexturesDirty = true;
+    return;
+  }
+  if(Row0 < State->DirtyRow0){ State->DirtyRow0 = Row0; }
+  if(Row1 > State->DirtyRow1){ State->DirtyRow1 = Row1; }
+  if(Col0 < State->DirtyCol0){ State->DirtyCol0 = Col0; }
+  if(Col1 > State->DirtyCol1){ State->DirtyCol1 = Col1; }
+}
+
+// (Rows [Row0 + Begin, Row0 + End) of a CompositeMapRegion rect)
+#define COMPOSITE_JOB_PIXELS 16384
+struct composite_rows_job{
+  int32 Row0;
+  int32 Col0, Col1;
+};
+
+internal void CompositeRowsJob(void* Data, uint32 Begin, uint32 End){
+  composite_rows_job* Job = (composite_rows_job*)Data;
+  // (Map rows are stored in GL order, so each scanline is one contiguous copy per chunk it crosses)
+  for(int32 Row = Job->Row0 + (int32)Begin; Row < Job->Row0 + (int32)End; ++Row){
+    int DstIndex = OX(Row, Job->Col0);
+    CopyWorldRow(Row, Job->Col0 + GlobalGameMap.XOffset, Job->Col1 - Job->Col0,
+		 &GlobalGLRenderer.Pixels[DstIndex], &GlobalGLRenderer.Angles[DstIndex]);
+  }
+}
+
+// (Copy background (color + angle) into the screen rect [Row0, Row1) x [Col0, Col1), screen coordinates)
+internal void CompositeMapRegion(int32 Row0, int32 Row1, int32 Col0, int32 Col1){
+  if(Row0 < 0){ Row0 = 0; }
+  if(Row1 > (int32)InternalHeight){ Row1 = InternalHeight; }
+  if(Col0 < 0){ Col0 = 0; }
+  if(Col1 > (int32)InternalWidth){ Col1 = InternalWidth; }
+
+  // (Clip to the map's columns)
+  if(Col0 + GlobalGameMap.XOffset < 0){ Col0 = -GlobalGameMap.XOffset; }
+  if(Col1 + GlobalGameMap.XOffset > GlobalGameMap.Width){ Col1 = GlobalGameMap.Width - GlobalGameMap.XOffset; }
+  if(Row0 >= Row1 || Col0 >= Col1){ return; }
+
+  // (Bands of rows across the job system: small rects (sprite restore, scroll columns) stay one inline job)
+  composite_rows_job Job = { Row0, Col0, Col1 };
+  uint32 RowsPerJob = COMPOSITE_JOB_PIXELS / (Col1 - Col0);
+  ParallelForWait(&GlobalJobSystem, Row1 - Row0, RowsPerJob ? RowsPerJob : 1, CompositeRowsJob, &Job);
+  MarkScreenDirty(Row0, Row1, Col0, Col1);
+}
+
+// (Screen rect touched by the sprite for a given state: covers both forward + reversed placement)
+internal void RestoreSpriteBackground(int32 PlayerXOffset, int32 PlayerBottomOffset){
+  CompositeMapRegion(PlayerBottomOffset, PlayerBottomOffset + SpriteHeight, PlayerXOffset, PlayerXOffset + SpriteWidth + 1);
+}
+
+// (Slide both screen buffers sideways by Delta columns (camera moved right by Delta), keeping rows intact)
+internal void ScrollScreenBuffers(int32 Delta){
+  int32 Keep = InternalWidth - (Delta > 0 ? Delta : -Delta);
+  for(int32 Row = 0; Row < (int32)InternalHeight; ++Row){
+    uint32* PixelRow = &GlobalGLRenderer.Pixels[OX(Row, 0)];
+    uint32* AngleRow = &GlobalGLRenderer.Angles[OX(Row, 0)];
+    if(Delta > 0){
+      memmove(PixelRow, PixelRow + Delta, Keep * sizeof(uint32));
+      memmove(AngleRow, AngleRow + Delta, Keep * sizeof(uint32));
+    }
+    else{
+      memmove(PixelRow - Delta, PixelRow, Keep * sizeof(uint32));
+      memmove(AngleRow - Delta, AngleRow, Keep * sizeof(uint32));
+    }
+  }
+  MarkScreenDirty(0, InternalHeight, 0, InternalWidth);
+}
+
+internal void BlitPlayerSprite(){
+  // (dictates frame of animation)
+  int SpriteIndex = GlobalPlayerState.AnimFrame;
+  int32 SpriteRow0 = GlobalPlayerState.BottomOffset;
+  int32 SpriteCol0 = GlobalPlayerState.XOffset;
+  MarkScreenDirty(SpriteRow0 < 0 ? 0 : SpriteRow0,
+		  SpriteRow0 + (int32)SpriteHeight > (int32)InternalHeight ? InternalHeight : SpriteRow0 + SpriteHeight,
+		  SpriteCol0 < 0 ? 0 : SpriteCol0,
+		  SpriteCol0 + (int32)SpriteWidth + 1 > (int32)InternalWidth ? InternalWidth : SpriteCol0 + SpriteWidth + 1);
+  
+  int SpriteStartY = (SpriteIndex / SpritePitch) * SpriteHeight;
+  int SpriteStartX = (SpriteIndex % SpritePitch) * SpriteWidth;
+
+  // Sprite Rendering
+  for(int i = 0; i < SpriteHeight; ++i){
+    for(int j = 0; j < SpriteWidth; ++j){
+      
+      int SrcIndex = ((SpriteStartY + i) * SpriteMapWidth) + (SpriteStartX + j);
+      if((GlobalSpriteMap.Pixels[SrcIndex] & Alpha) != 0){
+
+	int DstRow = (GlobalPlayerState.BottomOffset + SpriteHeight - 1) - i;
+	int DstCol;
+	if(!GlobalPlayerState.PlayerReversed){ // Forward
+	  DstCol = GlobalPlayerState.XOffset + j;
+	}
+	else{ // Reversed
+	  DstCol = (GlobalPlayerState.XOffset + SpriteWidth) - j;
+	}
+	if(DstRow < 0 || DstRow >= (int32)InternalHeight || DstCol < 0 || DstCol >= (int32)InternalWidth){ continue; }
+	int DstIndex = OX(DstRow, DstCol);
+
+	// Foreground (opacity 253 within normal map)
+	if((GlobalGLRenderer.Angles[DstIndex] & 0XFF) != 253){
+	GlobalGLRenderer.Pixels[DstIndex] = GlobalSpriteMap.Pixels[SrcIndex]; }
+	
+      }
+    }
+  }
+}
+
+// (Load game map into GlobalGLRenderer.Pixels)
+// (Only redraws what changed since the last call: sprite moves restore + reblit the sprite rect,
+//  camera scrolls shift the buffers and fill the newly exposed columns, idle frames do nothing)
+internal void LoadInternalMap(){
+  TIMED_BLOCK(LoadInternalMap);
+  compositor_state* Prior = &GlobalCompositor;
+  StreamWorldChunks(&GlobalGameMap);
+
+  int32 ScrollDelta = GlobalGameMap.XOffset - Prior->XOffset;
+  bool32 SpriteChanged = (GlobalPlayerState.AnimFrame != Prior->AnimFrame ||
+			  GlobalPlayerState.PlayerReversed != Prior->PlayerReversed ||
+			  GlobalPlayerState.XOffset != Prior->PlayerXOffset ||
+			  GlobalPlayerState.BottomOffset != Prior->PlayerBottomOffset);
+
+  // (Jumps past a chunk recompose in full too: the sprite rect at the old camera may no longer be resident)
+  if(!Prior->Valid || ScrollDelta > WORLD_CHUNK_WIDTH || ScrollDelta < -WORLD_CHUNK_WIDTH){
+    // 1: Game Map: full recomposition
+    CompositeMapRegion(0, InternalHeight, 0, InternalWidth);
+  }
+  else if(ScrollDelta != 0){
+    // (Old sprite out at the old camera position, then shift + fill exposed columns)
+    int32 CurrentXOffset = GlobalGameMap.XOffset;
+    GlobalGameMap.XOffset = Prior->XOffset;
+    RestoreSpriteBackground(Prior->PlayerXOffset, Prior->PlayerBottomOffset);
+    GlobalGameMap.XOffset = CurrentXOffset;
+
+    ScrollScreenBuffers(ScrollDelta);
+    if(ScrollDelta > 0){ CompositeMapRegion(0, InternalHeight, InternalWidth - ScrollDelta, InternalWidth); }
+    else{ CompositeMapRegion(0, InternalHeight, 0, -ScrollDelta); }
+  }
+  else if(SpriteChanged){
+    RestoreSpriteBackground(Prior->PlayerXOffset, Prior->PlayerBottomOffset);
+  }
+  else{
+    // (Idle: nothing to recompose)
+    return;
+  }
+
+  BlitPlayerSprite();
+
+  Prior->Valid = true;
+  Prior->XOffset = GlobalGameMap.XOffset;
+  Prior->AnimFrame = GlobalPlayerState.AnimFrame;
+  Prior->PlayerReversed = GlobalPlayerState.PlayerReversed;
+  Prior->PlayerXOffset = GlobalPlayerState.XOffset;
+  Prior->PlayerBottomOffset = GlobalPlayerState.BottomOffset;
+}
+
+// (Switching back to the CPU path needs a full recomposition: the screen buffers went stale meanwhile)
+internal void SetRenderMode(render_mode Mode){
+  if(Mode == RenderMode_CPUComposite && GlobalGLRenderer.Mode != RenderMode_CPUComposite){
+    GlobalCompositor.Valid = false;
+  }
+  GlobalGLRenderer.Mode = Mode;
+}
+
+internal GLuint CreateNearestTexture(int32 Width, int32 Height, uint32* Texels){
+  GLuint Texture;
+  glGenTextures(1, &Texture);
+  glBindTexture(GL_TEXTURE_2D, Texture);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, Width, Height, 0,
+	       GL_RGBA, GL_UNSIGNED_INT_8_8_8_8, Texels);
+  return Texture;
+}
+
+// (Chunk into its ring column range of the resident map textures)
+internal void UploadWorldChunk(int32 Chunk, uint32* Pixels, uint32* Angles){
+  int32 RingX = (Chunk % WORLD_RESIDENT_CHUNKS) * WORLD_CHUNK_WIDTH;
+  glBindTexture(GL_TEXTURE_2D, GlobalGLRenderer.MapTexture);
+  glTexSubImage2D(GL_TEXTURE_2D, 0, RingX, 0, WORLD_CHUNK_WIDTH, InternalHeight, GL_RGBA, GL_UNSIGNED_INT_8_8_8_8, Pixels);
+  glBindTexture(GL_TEXTURE_2D, GlobalGLRenderer.MapAngleTexture);
+  glTexSubImage2D(GL_TEXTURE_2D, 0, RingX, 0, WORLD_CHUNK_WIDTH, InternalHeight, GL_RGBA, GL_UNSIGNED_INT_8_8_8_8, Angles);
+}
+
+// (Map ring (color + angle) with the chunks resident so far, and the sprite sheet, once per scene load (after
+//  StreamWorldChunks): chunks still on their way follow in render frames)
+internal void UploadResidentSceneTextures(){
+  if(GlobalGLRenderer.MapTexture){
+    GLuint OldTextures[] = { GlobalGLRenderer.MapTexture, GlobalGLRenderer.MapAngleTexture, GlobalGLRenderer.SpriteTexture };
+    glDeleteTextures(ArrayCount(OldTextures), OldTextures);
+  }
+  // (Map rows are already in GL order; the sprite sheet stays top-down and is read with texelFetch)
+  GlobalGLRenderer.MapTexture = CreateNearestTexture(WORLD_RESIDENT_CHUNKS * WORLD_CHUNK_WIDTH, InternalHeight, 0);
+  GlobalGLRenderer.MapAngleTexture = CreateNearestTexture(WORLD_RESIDENT_CHUNKS * WORLD_CHUNK_WIDTH, InternalHeight, 0);
+  GlobalGLRenderer.MapWidth = GlobalGameMap.Width;
+  GlobalGLRenderer.BaseShader->Use();
+  GlobalGLRenderer.BaseShader->SetInt(GlobalGLRenderer.NormalDecodeLocation, GlobalGameMap.NormalDecode);
+  while(world_chunk_slot* Slot = NextWorldChunkUpload()){
+    UploadWorldChunk(Slot->Chunk, Slot->Pixels, Slot->Angles);
+  }
+  GlobalGLRenderer.SpriteTexture = CreateNearestTexture(SpriteMapWidth, SpriteMapHeight, GlobalSpriteMap.Pixels);
+  CheckGLError("After resident scene upload");
+}
+
+// (Copy the dirty rect of Source into the mapped PBO and update Texture from it)
+// (The texture update then runs as a GPU-side copy instead of a synchronous read of client memory)
+internal void StreamScreenRect(GLuint Texture, GLuint PBO, uint32* Source,
+			       int32 Row0, int32 Row1, int32 Col0, int32 Col1){
+  int32 Width = Col1 - Col0;
+  int32 Height = Row1 - Row0;
+  size_t RowBytes = Width * sizeof(uint32);
+
+  glBindTexture(GL_TEXTURE_2D, Texture);
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, PBO);
+  // (Invalidate: the driver may hand back fresh storage; unsynchronized: never wait on the previous user of this PBO)
+  uint8* Dest = (uint8*)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, Height * RowBytes,
+					 GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+  if(Dest){
+    for(int32 Row = Row0; Row < Row1; ++Row){
+      memcpy(Dest, &Source[OX(Row, Col0)], RowBytes);
+      Dest += RowBytes;
+    }
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, Col0, Row0, Width, Height,
+		    GL_RGBA, GL_UNSIGNED_INT_8_8_8_8, (void*)0); // (Offset into the bound PBO)
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  }
+  else{
+    // (Mapping failed: fall back to a client-memory upload of the whole screen)
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, InternalWidth, InternalHeight,
+		    GL_RGBA, GL_UNSIGNED_INT_8_8_8_8, Source);
+  }
+}
+
+// (Base pass inputs for Frame: render side, called with the base shader in use)
+// (Blend: see RenderFrameBlend)
+internal void BindBaseTextures(render_frame* Frame, real32 Blend){
+  Shader* BaseShader = GlobalGLRenderer.BaseShader;
+
+  // (Chunks the sim made resident since the last frame go into the map ring whichever mode draws)
+  if(!Frame->Draws){
+    glActiveTexture(GL_TEXTURE0);
+    for(int32 i = 0; i < Frame->ChunkUploadCount; ++i){
+      UploadWorldChunk(Frame->ChunkUploads[i], &Frame->ChunkPixels[i * WorldChunkTexels], &Frame->ChunkAngles[i * WorldChunkTexels]);
+    }
+  }
+
+  // (Unit 3 in both modes: per-tile light lists)
+  glActiveTexture(GL_TEXTURE3);
+  glBindTexture(GL_TEXTURE_BUFFER, GlobalLightingSystem.LightTileTexture);
+
+  if(Frame->Mode == RenderMode_GPUScroll){
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, GlobalGLRenderer.MapTexture);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, GlobalGLRenderer.MapAngleTexture);
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_2D, GlobalGLRenderer.SpriteTexture);
+
+    // (Camera + player sprite: the only per-frame state. Camera and sprite column are blended between steps,
+    //  so scrolling stays smooth above the sim rate)
+    int32 SpriteIndex = Frame->SpriteIndex;
+    real32 MapXOffset = Frame->PrevMapXOffset + Blend * (Frame->MapXOffset - Frame->PrevMapXOffset);
+    real32 SpriteX = Frame->PrevSpriteX + Blend * (Frame->SpriteX - Frame->PrevSpriteX);
+    BaseShader->SetFloat(GlobalGLRenderer.MapXOffsetLocation, MapXOffset);
+    // (Lights were placed for the step's camera: moved with the blended one (culled wide enough, see
+    //  lighting_system::CullMarginX))
+    BaseShader->SetFloat(GlobalGLRenderer.LightShiftXLocation, (real32)Frame->MapXOffset - MapXOffset);
+    BaseShader->SetInt(GlobalGLRenderer.MapWidthLocation, GlobalGLRenderer.MapWidth);
+    BaseShader->SetVec2(GlobalGLRenderer.SpritePositionLocation, SpriteX, (real32)Frame->SpriteY);
+    BaseShader->SetIVec2(GlobalGLRenderer.SpriteSheetOriginLocation,
+			 (SpriteIndex % SpritePitch) * SpriteWidth, (SpriteIndex / SpritePitch) * SpriteHeight);
+    BaseShader->SetInt(GlobalGLRenderer.SpriteReversedLocation, Frame->SpriteReversed ? 1 : 0);
+  }
+  else{
+    // (Re-upload only the rect LoadInternalMap recomposed since the last frame, through the PBO ring)
+    // (The composed screen is only as fresh as the last step: nothing to blend)
+    uint32 PBOIndex = GlobalGLRenderer.ScreenPBOIndex;
+    bool32 Upload = Frame->ScreenDirty && !Frame->Draws;
+    if(Upload){
+      GlobalGLRenderer.ScreenPBOIndex = (PBOIndex + 1) % ScreenPBOCount;
+    }
+
+    glActiveTexture(GL_TEXTURE0);
+    if(Upload){
+      StreamScreenRect(GlobalGLRenderer.MainTexture, GlobalGLRenderer.PixelPBOs[PBOIndex], Frame->Pixels,
+		       Frame->DirtyRow0, Frame->DirtyRow1, Frame->DirtyCol0, Frame->DirtyCol1);
+    }
+    else{
+      glBindTexture(GL_TEXTURE_2D, GlobalGLRenderer.MainTexture);
+    }
+    glActiveTexture(GL_TEXTURE1);
+    if(Upload){
+      StreamScreenRect(GlobalGLRenderer.AngleTexture, GlobalGLRenderer.AnglePBOs[PBOIndex], Frame->Angles,
+		       Frame->DirtyRow0, Frame->DirtyRow1, Frame->DirtyCol0, Frame->DirtyCol1);
+    }
+    else{
+      glBindTexture(GL_TEXTURE_2D, GlobalGLRenderer.AngleTexture);
+    }
+
+    // (Sprite is already composed in: screen texture read as-is)
+    BaseShader->SetFloat(GlobalGLRenderer.MapXOffsetLocation, 0.0f);
+    BaseShader->SetFloat(GlobalGLRenderer.LightShiftXLocation, 0.0f);
+    BaseShader->SetInt(GlobalGLRenderer.MapWidthLocation, InternalWidth);
+    BaseShader->SetIVec2(GlobalGLRenderer.SpriteSheetOriginLocation, -1, -1);
+  }
+}
+
+// (Sim side, after this frame's simulation (rain_system::Update has already filled the back slot's rain):
+//  capture everything else rendering reads into the queue's back slot)
+// (DueTime: see render_frame)
+internal void BuildRenderFrame(render_frame_queue* Queue, real64 DueTime){
+  render_frame* Frame = SimRenderFrame(Queue);
+  Frame->DueTime = DueTime;
+  Frame->Draws = 0;
+  Frame->Mode = GlobalGLRenderer.Mode;
+  Frame->MapXOffset = GlobalGameMap.XOffset;
+  Frame->SpriteX = GlobalPlayerState.XOffset;
+  if(!Queue->Published){
+    Queue->LastMapXOffset = Frame->MapXOffset;
+    Queue->LastSpriteX = Frame->SpriteX;
+  }
+  Frame->PrevMapXOffset = Queue->LastMapXOffset;
+  Frame->PrevSpriteX = Queue->LastSpriteX;
+  Queue->LastMapXOffset = Frame->MapXOffset;
+  Queue->LastSpriteX = Frame->SpriteX;
+  Frame->SpriteY = GlobalPlayerState.BottomOffset;
+  Frame->SpriteIndex = GlobalPlayerState.AnimFrame;
+  Frame->SpriteReversed = GlobalPlayerState.PlayerReversed;
+
+  // (Map chunks that became resident since the last frame, for the GPU ring: uploaded in either mode, so a
+  //  switch to GPU scroll finds the ring current. A frame the render side never took is about to be replaced,
+  //  so its chunks are sent again)
+  render_frame* Unread = UnreadRenderFrame(Queue);
+  if(Unread){
+    for(int32 i = 0; i < Unread->ChunkUploadCount; ++i){ ResendWorldChunk(Unread->ChunkUploads[i]); }
+  }
+  StreamWorldChunks(&GlobalGameMap);
+  Frame->ChunkUploadCount = 0;
+  while(Frame->ChunkUploadCount < WORLD_MAX_CHUNK_UPLOADS){
+    world_chunk_slot* Slot = NextWorldChunkUpload();
+    if(!Slot){ break; }
+    uint32 Texel = Frame->ChunkUploadCount * WorldChunkTexels;
+    memcpy(&Frame->ChunkPixels[Texel], Slot->Pixels, WorldChunkTexels * sizeof(uint32));
+    memcpy(&Frame->ChunkAngles[Texel], Slot->Angles, WorldChunkTexels * sizeof(uint32));
+    Frame->ChunkUploads[Frame->ChunkUploadCount++] = Slot->Chunk;
+  }
+
+  // (Composed screen: only the rect that changed is copied. Like the chunks, an unread frame's rect rides
+  //  along in this one)
+  Frame->ScreenDirty = false;
+  if(Frame->Mode == RenderMode_CPUComposite){
+    compositor_state* State = &GlobalCompositor;
+    if(Unread && Unread->ScreenDirty){
+      MarkScreenDirty(Unread->DirtyRow0, Unread->DirtyRow1, Unread->DirtyCol0, Unread->DirtyCol1);
+    }
+    if(State->TexturesDirty){
+      size_t RowBytes = (State->DirtyCol1 - State->DirtyCol0) * sizeof(uint32);
+      for(int32 Row = State->DirtyRow0; Row < State->DirtyRow1; ++Row){
+	int32 Index = OX(Row, State->DirtyCol0);
+	memcpy(&Frame->Pixels[Index], &GlobalGLRenderer.Pixels[Index], RowBytes);
+	memcpy(&Frame->Angles[Index], &GlobalGLRenderer.Angles[Index], RowBytes);
+      }
+      Frame->ScreenDirty = true;
+      Frame->DirtyRow0 = State->DirtyRow0; Frame->DirtyRow1 = State->DirtyRow1;
+      Frame->DirtyCol0 = State->DirtyCol0; Frame->DirtyCol1 = State->DirtyCol1;
+      State->TexturesDirty = false;
+    }
+  }
+
+  // (GPU scroll draws the lights up to this step's scroll off where they are placed (lightShiftX))
+  int32 StepScroll = (Frame->Mode == RenderMode_GPUScroll) ? abs(Frame->MapXOffset - Frame->PrevMapXOffset) : 0;
+  GlobalLightingSystem.SetCullMargin((real32)StepScroll);
+  StreamMapLights(&GlobalGameMap);
+  GlobalLightingSystem.UpdateLightBlock();
+  if(Frame->LightVersion != GlobalLightingSystem.BlockVersion){
+    GlobalLightingSystem.CopyLightBlock(&Frame->Lights);
+    Frame->LightTileCount = GlobalLightingSystem.TileEntryCount;
+    memcpy(Frame->LightTiles, GlobalLightingSystem.TileEntries, sizeof(uint32) * Frame->LightTileCount);
+    Frame->LightVersion = GlobalLightingSystem.BlockVersion;
+  }
+  Frame->LightMode = GlobalLightingSystem.RenderMode;
+}
+
+// (Render side: full-screen base pass for Frame (the platform layer clears, draws rain on top and presents))
+internal void RenderBasePass(render_frame* Frame, real32 Blend){
+  Shader* BaseShader = GlobalGLRenderer.BaseShader;
+  BaseShader->Use();
+  GlobalLightingSystem.UploadLightBlock(&Frame->Lights, Frame->LightTiles, Frame->LightTileCount, Frame->LightVersion);
+
+  // (Map + angle textures: resident chunk ring (GPU scroll) or the composed screen (CPU composite))
+  BindBaseTextures(Frame, Blend);
+
+  glBindVertexArray(GlobalGLRenderer.FrameVAO);
+  if(Frame->LightMode == LightRender_Volumes){
+    BaseShader->SetInt(GlobalGLRenderer.LightPassLocation, LightPass_Unlit);
+    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+
+    // (Each light's quad only covers its radius: fragment cost follows the lit area. Contributions add up in
+    //  the framebuffer, whose clamp on write matches the tiled pass' min(..., 1))
+    BaseShader->SetInt(GlobalGLRenderer.LightPassLocation, LightPass_Volume);
+    glBlendFunc(GL_ONE, GL_ONE);
+    glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, Frame->Lights.NumActiveLights);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  }
+  else{
+    BaseShader->SetInt(GlobalGLRenderer.LightPassLocation, LightPass_Tiled);
+    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+  }
+}
+
+// (OpenGL Texturing Init.)
+// (ParticleSeed: all particle spawning draws from series seeded with it, so runs are reproducible)
+internal void InitGlobalGLRendering(uint64 ParticleSeed){
+  GlobalGLRenderer.Mode = RenderMode_GPUScroll;
+
+  {/* 1: Shader Loading / Init */}
+  {
+    // (Base shader)
+    GlobalGLRenderer.BaseShader = new Shader("../driver/shader.vert", "../driver/shader.frag");
+    // (Rain shader)
+    GlobalGLRenderer.RainShader = new Shader("../driver/rain.vert", "../driver/rain.frag");
+    GlobalGLRenderer.RainStatelessShader = new Shader("../driver/rain_stateless.vert", "../driver/rain.frag");
+    const char* RainFeedbackVaryings[] = { "outPosition", "outVelocity", "outSeed" };
+    GlobalGLRenderer.RainUpdateShader = new Shader("../driver/rain_update.vert", 0, RainFeedbackVaryings, ArrayCount(RainFeedbackVaryings));
+
+    // CURR TEST:
+    GlobalLightingSystem.ClearLights();
+    GlobalLightingSystem.InitGL(GlobalGLRenderer.BaseShader);
+    /* 
+    GlobalLightingSystem.AddLight(InternalWidth / 2.0f, InternalHeight / 2.0f,
+				  1.0f, .8f, .6f, 1.0f, 100.0f
+				  );
+        GlobalLightingSystem.AddLight(InternalWidth / 4.0f, InternalHeight / 3.0f,
+				  1.0f, .8f, .6f, 5.0f, 200.0f
+				  ); */
+  }
+
+  {/* 2: Base Scene Setup */ }
+  {
+    real32 BaseVertices[] = {
+      // positions        // texture coords
+      -1.0f,  1.0f, 0.0f,  0.0f, 1.0f,
+      1.0f,  1.0f, 0.0f,  1.0f, 1.0f,
+      1.0f, -1.0f, 0.0f,  1.0f, 0.0f,
+      -1.0f, -1.0f, 0.0f,  0.0f, 0.0f
+    };
+        
+    uint32 BaseIndices[] = {
+      0, 1, 2,
+      2, 3, 0    
+    };
+
+    // Generate and bind base VAO/VBO/EBO
+    glGenVertexArrays(1, &GlobalGLRenderer.FrameVAO);
+    glGenBuffers(1, &GlobalGLRenderer.FrameVBO);
+    glGenBuffers(1, &GlobalGLRenderer.FrameEBO);
+        
+    glBindVertexArray(GlobalGLRenderer.FrameVAO);
+        
+    glBindBuffer(GL_ARRAY_BUFFER, GlobalGLRenderer.FrameVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(BaseVertices), BaseVertices, GL_STATIC_DRAW);
+        
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, GlobalGLRenderer.FrameEBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(BaseIndices), BaseIndices, GL_STATIC_DRAW);
+        
+    // (Position attribute)
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    // (Texture coords attribute)
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+  }
+  
+  {/* 3: Rain Scene Setup */}
+  {
+    InitRenderFrameQueue(&GlobalFrameQueue);
+    GlobalRainSystem.Entropy = RandomSeed(ParticleSeed);
+    GlobalRainSystem.InitGL();
+    GlobalRainSystem.InitSystem(DEFAULT_RAIN_CAPACITY, (uint32)(.9 * DEFAULT_RAIN_CAPACITY));
+    GlobalRainSystem.InitStateless(GlobalRainSystem.ActiveCount);
+    GlobalRainSystem.InitFeedback(GlobalRainSystem.ActiveCount);
+  }
+
+  {/* 4: Texture Setup */}
+  {
+    // (A: Main scene texture)
+    glGenTextures(1, &GlobalGLRenderer.MainTexture);
+    glBindTexture(GL_TEXTURE_2D, GlobalGLRenderer.MainTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST); // (min filter)
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST); // (mag filter)
+
+    // (B: Angle textures)
+    glGenTextures(1, &GlobalGLRenderer.AngleTexture);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, GlobalGLRenderer.AngleTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    
+    
+    GlobalGLRenderer.Pixels = (uint32*)PlatformAllocateMemory(sizeof(uint32) * InternalWidth * InternalHeight);
+    GlobalGLRenderer.Angles = (uint32*)PlatformAllocateMemory(sizeof(uint32) * InternalWidth * InternalHeight);
+
+    
+    // (Initialize textures)
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, GlobalGLRenderer.MainTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, InternalWidth, InternalHeight, 0,
+                 GL_RGBA, GL_UNSIGNED_INT_8_8_8_8, GlobalGLRenderer.Pixels);
+
+
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, GlobalGLRenderer.AngleTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, InternalWidth, InternalHeight, 0,
+                 GL_RGBA, GL_UNSIGNED_INT_8_8_8_8, GlobalGLRenderer.Angles);
+
+    // (C: Upload ring: storage for a full screen each, written through glMapBufferRange)
+    glGenBuffers(ScreenPBOCount, GlobalGLRenderer.PixelPBOs);
+    glGenBuffers(ScreenPBOCount, GlobalGLRenderer.AnglePBOs);
+    for(uint32 i = 0; i < ScreenPBOCount; ++i){
+      glBindBuffer(GL_PIXEL_UNPACK_BUFFER, GlobalGLRenderer.PixelPBOs[i]);
+      glBufferData(GL_PIXEL_UNPACK_BUFFER, sizeof(uint32) * InternalWidth * InternalHeight, NULL, GL_STREAM_DRAW);
+      glBindBuffer(GL_PIXEL_UNPACK_BUFFER, GlobalGLRenderer.AnglePBOs[i]);
+      glBufferData(GL_PIXEL_UNPACK_BUFFER, sizeof(uint32) * InternalWidth * InternalHeight, NULL, GL_STREAM_DRAW);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    GlobalGLRenderer.ScreenPBOIndex = 0;
+    
+  }
+
+
+  // TODO: does this work as an end?
+  GlobalGLRenderer.BaseShader->Use();
+
+  GlobalGLRenderer.BaseShader->SetFloat("screenWidth", (float)InternalWidth);
+  GlobalGLRenderer.BaseShader->SetFloat("screenHeight", (float)InternalHeight);
+  
+  GlobalGLRenderer.BaseShader->SetInt("gameTexture", 0);
+  GlobalGLRenderer.BaseShader->SetInt("angleTexture", 1);
+  GlobalGLRenderer.BaseShader->SetInt("spriteTexture", 2);
+  GlobalGLRenderer.BaseShader->SetInt("lightTiles", 3);
+
+  GlobalGLRenderer.MapXOffsetLocation = GlobalGLRenderer.BaseShader->GetUniformLocation("mapXOffset");
+  GlobalGLRenderer.LightShiftXLocation = GlobalGLRenderer.BaseShader->GetUniformLocation("lightShiftX");
+  GlobalGLRenderer.NormalDecodeLocation = GlobalGLRenderer.BaseShader->GetUniformLocation("normalDecode");
+  GlobalGLRenderer.MapWidthLocation = GlobalGLRenderer.BaseShader->GetUniformLocation("mapWidth");
+  GlobalGLRenderer.SpritePositionLocation = GlobalGLRenderer.BaseShader->GetUniformLocation("spritePosition");
+  GlobalGLRenderer.SpriteSheetOriginLocation = GlobalGLRenderer.BaseShader->GetUniformLocation("spriteSheetOrigin");
+  GlobalGLRenderer.SpriteReversedLocation = GlobalGLRenderer.BaseShader->GetUniformLocation("spriteReversed");
+  GlobalGLRenderer.LightPassLocation = GlobalGLRenderer.BaseShader->GetUniformLocation("lightPass");
+  
+  GlobalGLRenderer.RainShader->Use();
+  GlobalGLRenderer.RainShader->SetInt("rainTexture", 0);
+  GlobalGLRenderer.RainShader->SetFloat("simHz", (real32)GlobalSimHz);
+  GlobalGLRenderer.RainStatelessShader->Use();
+  GlobalGLRenderer.RainStatelessShader->SetInt("rainTexture", 0);
+  GlobalGLRenderer.RainStatelessShader->SetFloat("simHz", (real32)GlobalSimHz);
+  
+  glEnable(GL_BLEND);
+  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+  CheckGLError("After init global GL");
+
+  // GlobalRainSystem.InitSystem();
+
+  // blue blit (TODO: replace with game screen blit)
+  // for(int i = 0; i < InternalHeight; ++i){for(int j = 0; j < InternalWidth; ++j){ GlobalGLRenderer.Pixels[OX(i,j)] = Alpha|Blue; }}
+  // for(int i = 0; i < 100; ++i){ GlobalGLRenderer.Pixels[OX(i, 100)] = Alpha|Red|Blue;}
+  
+}
+
+// (Game + sprite map allocation / population from the source PNGs (what the scene pack is cooked from))
+internal void LoadScenePNGs(){
+  // (Game map init.)
+  int32 GameMapWidth = 720;
+  int32 GameMapSize = InternalHeight * GameMapWidth * sizeof(uint32);
+  GlobalGameMap.Pixels = (uint32*)PlatformAllocateMemory(GameMapSize);
+  GlobalGameMap.Angles = (uint32*)PlatformAllocateMemory(GameMapSize);
+  // (Sprite map init.)
+  int32 SpriteMapSize = SpriteMapWidth * SpriteMapHeight * sizeof(uint32);
+  GlobalSpriteMap.Pixels = (uint32*)PlatformAllocateMemory(SpriteMapSize);
+  // (Image loading / game map population)
+  GlobalGameMap.PackFile = 0;
+  GlobalGameMap.NormalDecode = GlobalNormalDecode;
+  GlobalGameMap.Width = GameMapWidth;
+  GlobalGameMap.ChunkCount = WorldChunkCount(GameMapWidth);
+  LoadGameMap(&GlobalGameMap, "../media/Scene1.png");
+  LoadNormalMap(&GlobalGameMap, "../media/NormalMap1.png");
+  LoadSpriteMap(&GlobalSpriteMap, "../media/Anim1.png");
+  IndexLightEmitters(&GlobalGameMap);
+}
+
+// (Release the loaded scene, if any: the streamer is stopped first, so no chunk read is left on the pack file
+//  when it is closed and unmapped. The map's lights are retired with it)
+internal void UnloadGameScene(){
+  StopWorldStreamer();
+  for(int32 i = GlobalGameMap.StreamedFirst; i < GlobalGameMap.StreamedLast; ++i){
+    GlobalLightingSystem.RemoveLight(GlobalGameMap.Emitters[i].Light);
+  }
+  if(GlobalGameMap.PackFile){ PlatformCloseFile(GlobalGameMap.PackFile); }
+  if(GlobalGameMap.Pack.Memory){
+    // (Emitters and the sprite sheet point into the mapping)
+    PlatformUnmapFile(&GlobalGameMap.Pack);
+  }
+  else{
+    if(GlobalGameMap.Pixels){ PlatformFreeMemory(GlobalGameMap.Pixels); }
+    if(GlobalGameMap.Angles){ PlatformFreeMemory(GlobalGameMap.Angles); }
+    if(GlobalGameMap.Emitters){ PlatformFreeMemory(GlobalGameMap.Emitters); }
+    if(GlobalSpriteMap.Pixels){ PlatformFreeMemory(GlobalSpriteMap.Pixels); }
+  }
+  GlobalGameMap = {};
+  GlobalSpriteMap = {};
+}
+
+// (Scene load: the cooked pack if there is one for this build's layout, else the PNGs (always for
+//  NormalDecode_Trig: the pack's normals are decoded). Unloads the current scene first)
+// (Requires InitGlobalGLRendering() for the frame buffers)
+internal void LoadGameScene(){
+  UnloadGameScene();
+  GlobalGameMap.XOffset = 0;
+  if(GlobalNormalDecode != NormalDecode_Load || !LoadScenePack(&GlobalGameMap, &GlobalSpriteMap, "../media/Scene1.pack")){
+    LoadScenePNGs();
+  }
+  ResetWorldStreamer(&GlobalGameMap);
+  StreamWorldChunks(&GlobalGameMap);
+  UploadResidentSceneTextures();
+
+  GlobalCompositor.Valid = false;
+  LoadInternalMap();
+}
+
+#define GAME_H
+#endif
@@ -0,0 +1,357 @@
+#if !defined(JOBS_H)
+
+// (Work-stealing job system: a fixed pool of workers, each owning one deque of jobs. The thread that calls
+//  JobSystemInit is worker 0; the rest are platform threads. Owners push / pop at the bottom of their own
+//  deque (LIFO, cache-warm), idle workers steal from the top of someone else's (FIFO, the biggest leftovers))
+// (A job is a range [Begin, End) of some Proc's work; job_counters track completion and double as dependencies)
+
+// ATOMICS (x86: aligned loads / stores are atomic, interlocked ops are full barriers)
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define CompilerBarrier() _ReadWriteBarrier()
+inline int32 AtomicAddI32(volatile int32* Value, int32 Addend){
+  return _InterlockedExchangeAdd((volatile long*)Value, Addend) + Addend;
+}
+inline uint64 AtomicAddU64(volatile uint64* Value, uint64 Addend){
+  return (uint64)_InterlockedExchangeAdd64((volatile long long*)Value, (long long)Addend) + Addend;
+}
+inline int32 AtomicExchangeI32(volatile int32* Value, int32 New){
+  return _InterlockedExchange((volatile long*)Value, New);
+}
+inline int32 AtomicCompareExchangeI32(volatile int32* Value, int32 New, int32 Expected){
+  return _InterlockedCompareExchange((volatile long*)Value, New, Expected);
+}
+inline int64 AtomicCompareExchangeI64(volatile int64* Value, int64 New, int64 Expected){
+  return _InterlockedCompareExchange64((volatile long long*)Value, New, Expected);
+}
+#else
+#define CompilerBarrier() __asm__ __volatile__("" ::: "memory")
+inline int32 AtomicAddI32(volatile int32* Value, int32 Addend){
+  return __sync_add_and_fetch(Value, Addend);
+}
+inline uint64 AtomicAddU64(volatile uint64* Value, uint64 Addend){
+  return __sync_add_and_fetch(Value, Addend);
+}
+inline int32 AtomicExchangeI32(volatile int32* Value, int32 New){
+  return __atomic_exchange_n(Value, New, __ATOMIC_SEQ_CST);
+}
+inline int32 AtomicCompareExchangeI32(volatile int32* Value, int32 New, int32 Expected){
+  return __sync_val_compare_and_swap(Value, Expected, New);
+}
+inline int64 AtomicCompareExchangeI64(volatile int64* Value, int64 New, int64 Expected){
+  return __sync_val_compare_and_swap(Value, Expected, New);
+}
+#endif
+// (Store -> load ordering: the one reordering x86 does)
+#define FullBarrier() _mm_mfence()
+
+// JOBS
+
+typedef void job_proc(void* Data, uint32 Begin, uint32 End);
+
+// (Jobs still to finish: ParallelFor adds to it before queueing, each job subtracts one when done)
+struct job_counter{
+  volatile int32 Pending;
+};
+
+struct job{
+  job_proc* Proc;
+  void* Data;
+  uint32 Begin, End;
+  job_counter* Counter; // (0: nobody waits on this job)
+  job_counter* Dependency; // (0: runnable now, otherwise held back until Dependency->Pending reaches zero)
+};
+
+inline bool32 JobIsReady(job* Job){
+  return !Job->Dependency || Job->Dependency->Pending <= 0;
+}
+
+inline void RunJob(job* Job){
+  Job->Proc(Job->Data, Job->Begin, Job->End);
+  if(Job->Counter){ AtomicAddI32(&Job->Counter->Pending, -1); }
+}
+
+// (Chase-Lev deque over a fixed ring: Top / Bottom only ever grow, so a slot index never repeats while a thief
+//  is reading it (the owner refuses to push into a full ring and runs the job itself instead))
+#define JOB_DEQUE_SIZE 256 // (Power of two)
+struct job_deque{
+  volatile int64 Top; // (Next steal: advanced by CAS)
+  volatile int64 Bottom; // (Next push: written by the owner only)
+  job Jobs[JOB_DEQUE_SIZE];
+};
+
+internal bool32 JobDequePush(job_deque* Deque, job* Job){
+  int64 Bottom = Deque->Bottom;
+  if(Bottom - Deque->Top >= JOB_DEQUE_SIZE){ return false; }
+  Deque->Jobs[Bottom & (JOB_DEQUE_SIZE - 1)] = *Job;
+  CompilerBarrier(); // (Job written before it becomes visible)
+  Deque->Bottom = Bottom + 1;
+  return true;
+}
+
+internal bool32 JobDequePop(job_deque* Deque, job* Result){
+  int64 Bottom = Deque->Bottom - 1;
+  Deque->Bottom = Bottom;
+  FullBarrier(); // (Claim the slot before looking at Top)
+  int64 Top = Deque->Top;
+  if(Top > Bottom){
+    // (Empty)
+    Deque->Bottom = Bottom + 1;
+    return false;
+  }
+  *Result = Deque->Jobs[Bottom & (JOB_DEQUE_SIZE - 1)];
+  if(Top == Bottom){
+    // (Last job: race any thief for it through Top)
+    bool32 Won = (AtomicCompareExchangeI64(&Deque->Top, Top + 1, Top) == Top);
+    Deque->Bottom = Bottom + 1;
+    return Won;
+  }
+  return true;
+}
+
+internal bool32 JobDequeSteal(job_deque* Deque, job* Result){
+  int64 Top = Deque->Top;
+  FullBarrier();
+  int64 Bottom = Deque->Bottom;
+  if(Top >= Bottom){ return false; }
+  *Result = Deque->Jobs[Top & (JOB_DEQUE_SIZE - 1)];
+  CompilerBarrier();
+  return (AtomicCompareExchangeI64(&Deque->Top, Top + 1, Top) == Top);
+}
+
+// POOL
+
+#define MAX_JOB_WORKERS 32
+#define JOB_PARK_SIZE 64
+
+struct job_system;
+struct job_worker{
+  job_deque Deque;
+  job_system* System;
+  uint32 Index;
+  uint32 StealCursor; // (Victim to try first: rotates so thieves spread out)
+  // (Jobs this worker took whose dependency hasn't finished: owner-only, run as soon as they're ready)
+  job Parked[JOB_PARK_SIZE];
+  uint32 ParkedCount;
+  void* Thread; // (0 for worker 0)
+};
+
+struct job_system{
+  job_worker Workers[MAX_JOB_WORKERS];
+  uint32 WorkerCount; // (0: not started, everything runs inline on the caller)
+  void* WakeSemaphore; // (Idle workers sleep here)
+  volatile int32 SleepingCount;
+  volatile int32 Quit;
+};
+global_variable job_system GlobalJobSystem;
+
+// (Worker owned by the calling thread: 0 on threads outside the pool, which then run their jobs inline)
+global_variable thread_local job_worker* GlobalThreadWorker;
+
+internal bool32 JobSystemHasQueuedWork(job_system* System){
+  for(uint32 i = 0; i < System->WorkerCount; ++i){
+    job_deque* Deque = &System->Workers[i].Deque;
+    if(Deque->Bottom > Deque->Top){ return true; }
+  }
+  return false;
+}
+
+// (Set a job aside until its dependency finishes; false if the park is full)
+internal bool32 ParkJob(job_worker* Worker, job* Job){
+  if(Worker->ParkedCount >= JOB_PARK_SIZE){ return false; }
+  Worker->Parked[Worker->ParkedCount++] = *Job;
+  return true;
+}
+
+// (Run one job: parked jobs that became ready, then the own deque, then one steal attempt per other worker)
+// (Blocked jobs met on the way are parked, so they never hide the runnable jobs queued beneath them)
+internal bool32 RunNextJob(job_worker* Worker){
+  job_system* System = Worker->System;
+  job Job;
+
+  for(uint32 i = 0; i < Worker->ParkedCount; ++i){
+    if(JobIsReady(&Worker->Parked[i])){
+      Job = Worker->Parked[i];
+      Worker->Parked[i] = Worker->Parked[--Worker->ParkedCount];
+      RunJob(&Job);
+      return true;
+    }
+  }
+
+  while(JobDequePop(&Worker->Deque, &Job)){
+    if(JobIsReady(&Job)){
+      RunJob(&Job);
+      return true;
+    }
+    if(!ParkJob(Worker, &Job)){
+      JobDequePush(&Worker->Deque, &Job); // (Just popped: there is room)
+      break;
+    }
+  }
+
+  for(uint32 Attempt = 1; Attempt < System->WorkerCount; ++Attempt){
+    uint32 Victim = (Worker->Index + Worker->StealCursor + Attempt) % System->WorkerCount;
+    if(Victim == Worker->Index){ continue; }
+    if(JobDequeSteal(&System->Workers[Victim].Deque, &Job)){
+      Worker->StealCursor = Victim;
+      if(JobIsReady(&Job)){
+	RunJob(&Job);
+	return true;
+      }
+      if(!ParkJob(Worker, &Job) && !JobDequePush(&Worker->Deque, &Job)){
+	// (Nowhere to keep it: wait it out here)
+	while(!JobIsReady(&Job)){ _mm_pause(); }
+	RunJob(&Job);
+	return true;
+      }
+    }
+  }
+  return false;
+}
+
+internal void JobWorkerThread(void* Data){
+  job_worker* Worker = (job_worker*)Data;
+  job_system* System = Worker->System;
+  GlobalThreadWorker = Worker;
+
+  while(!System->Quit){
+    if(RunNextJob(Worker)){ continue; }
+    if(Worker->ParkedCount){
+      // (Holding blocked jobs: keep polling, nobody else will run them)
+      _mm_pause();
+      continue;
+    }
+
+    // (Nothing found: spin briefly (frames queue work in bursts), then sleep until a push wakes us)
+    bool32 FoundWork = false;
+    for(int32 Spin = 0; Spin < 256 && !FoundWork; ++Spin){
+      _mm_pause();
+      FoundWork = JobSystemHasQueuedWork(System);
+    }
+    if(FoundWork){ continue; }
+
+    // (Announce, then re-check: a push that missed the announcement is seen here instead)
+    AtomicAddI32(&System->SleepingCount, 1);
+    FullBarrier();
+    if(!System->Quit && !JobSystemHasQueuedWork(System)){
+      PlatformWaitSemaphore(System->WakeSemaphore);
+    }
+    AtomicAddI32(&System->SleepingCount, -1);
+  }
+}
+
+internal void WakeJobWorkers(job_system* System, uint32 JobCount){
+  FullBarrier(); // (Pushes visible before SleepingCount is read)
+  int32 Sleeping = System->SleepingCount;
+  if(Sleeping > 0){
+    PlatformSignalSemaphore(System->WakeSemaphore, JobCount < (uint32)Sleeping ? JobCount : (uint32)Sleeping);
+  }
+}
+
+// (WorkerCount includes the calling thread: 1 = no extra threads, jobs still go through the deque)
+internal void JobSystemInit(job_system* System, uint32 WorkerCount){
+  if(WorkerCount < 1){ WorkerCount = 1; }
+  if(WorkerCount > MAX_JOB_WORKERS){ WorkerCount = MAX_JOB_WORKERS; }
+
+  System->WorkerCount = WorkerCount;
+  System->SleepingCount = 0;
+  System->Quit = 0;
+  System->WakeSemaphore = PlatformCreateSemaphore(MAX_JOB_WORKERS);
+  for(uint32 i = 0; i < WorkerCount; ++i){
+    job_worker* Worker = &System->Workers[i];
+    Worker->Deque.Top = 0;
+    Worker->Deque.Bottom = 0;
+    Worker->System = System;
+    Worker->Index = i;
+    Worker->StealCursor = 0;
+    Worker->ParkedCount = 0;
+    Worker->Thread = 0;
+  }
+  GlobalThreadWorker = &System->Workers[0];
+  for(uint32 i = 1; i < WorkerCount; ++i){
+    System->Workers[i].Thread = PlatformCreateThread(JobWorkerThread, &System->Workers[i]);
+  }
+}
+
+// (Call with no jobs outstanding)
+internal void JobSystemShutdown(job_system* System){
+  if(!System->WorkerCount){ return; }
+  System->Quit = 1;
+  PlatformSignalSemaphore(System->WakeSemaphore, System->WorkerCount);
+  for(uint32 i = 1; i < System->WorkerCount; ++i){
+    PlatformJoinThread(System->Workers[i].Thread);
+  }
+  PlatformDestroySemaphore(System->WakeSemaphore);
+  GlobalThreadWorker = 0;
+  System->WorkerCount = 0;
+}
+
+// (Queue on the calling thread's deque; outside the pool (or with the deque full) the job runs right here)
+internal void AddJob(job_system* System, job* Job){
+  job_worker* Worker = GlobalThreadWorker;
+  if(Worker && Worker->System == System && JobDequePush(&Worker->Deque, Job)){ return; }
+  while(!JobIsReady(Job)){
+    if(!Worker || !RunNextJob(Worker)){ _mm_pause(); }
+  }
+  RunJob(Job);
+}
+
+// (Block until Counter drains, running queued jobs meanwhile instead of idling)
+internal void WaitForJobs(job_system* System, job_counter* Counter){
+  job_worker* Worker = GlobalThreadWorker;
+  if(!Worker || Worker->System != System){
+    while(Counter->Pending > 0){ _mm_pause(); }
+    return;
+  }
+  while(Counter->Pending > 0){
+    if(!RunNextJob(Worker)){ _mm_pause(); }
+  }
+  // (Worker 0 only runs jobs while it waits: hand anything it parked back to the deque for the pool threads)
+  if(Worker->Index == 0 && Worker->ParkedCount){
+    uint32 Released = 0;
+    while(Worker->ParkedCount && JobDequePush(&Worker->Deque, &Worker->Parked[Worker->ParkedCount - 1])){
+      --Worker->ParkedCount;
+      ++Released;
+    }
+    WakeJobWorkers(System, Released);
+  }
+}
+
+// (Split [0, Count) into ChunkSize ranges and queue them, counted on Counter; returns immediately)
+// (Chunk boundaries depend only on Count and ChunkSize, never on the worker count, so results that depend on
+//  the split (e.g. per-chunk random streams) are the same on every machine)
+internal void ParallelFor(job_system* System, uint32 Count, uint32 ChunkSize, job_proc* Proc, void* Data,
+			  job_counter* Counter, job_counter* Dependency = 0){
+  if(Count == 0){ return; }
+  if(ChunkSize == 0){ ChunkSize = 1; }
+  uint32 ChunkCount = (Count + ChunkSize - 1) / ChunkSize;
+  if(ChunkCount == 1 && !Dependency){
+    // (One chunk: not worth a queue round-trip)
+    Proc(Data, 0, Count);
+    return;
+  }
+
+  AtomicAddI32(&Counter->Pending, (int32)ChunkCount);
+  for(uint32 Chunk = 0; Chunk < ChunkCount; ++Chunk){
+    job Job;
+    Job.Proc = Proc;
+    Job.Data = Data;
+    Job.Begin = Chunk * ChunkSize;
+    Job.End = (Chunk == ChunkCount - 1) ? Count : Job.Begin + ChunkSize;
+    Job.Counter = Counter;
+    Job.Dependency = Dependency;
+    AddJob(System, &Job);
+  }
+  WakeJobWorkers(System, ChunkCount);
+}
+
+// (ParallelFor + WaitForJobs)
+internal void ParallelForWait(job_system* System, uint32 Count, uint32 ChunkSize, job_proc* Proc, void* Data){
+  job_counter Counter = {};
+  ParallelFor(System, Count, ChunkSize, Proc, Data, &Counter);
+  WaitForJobs(System, &Counter);
+}
+
+#define JOBS_H
+#endif
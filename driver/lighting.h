@@ -0,0 +1,354 @@
+#if !defined(LIGHTING_H)
+
+struct light_source{
+  real32 PosX, PosY;
+  real32 R, G, B;
+  real32 Intensity;
+  real32 Radius;
+};
+struct light_slot{
+  uint32 Generation; // (Odd while in use)
+  int32 DenseIndex;
+};
+// (std140 mirror of shader.frag's LightBlock: one 32-byte entry per light)
+struct light_block_entry{
+  real32 Color[3];
+  real32 Intensity;
+  real32 Position[2];
+  real32 Radius;
+  real32 Pad;
+};
+static_assert(sizeof(light_block_entry) == 32, "light_block_entry must match the std140 Light stride");
+
+// (How the base pass lights the screen: F6 in game toggles)
+enum light_render_mode{
+  LightRender_Tiled, // (One full-screen pass, each pixel looping over its tile's lights (CullLightTiles))
+  LightRender_Volumes, // (Unlit full-screen pass, then one additive quad per light over its radius' bounds)
+
+  LightRender_Count
+};
+global_variable char* LightRenderModeNames[LightRender_Count] = {
+  "tiled",
+  "volumes",
+};
+
+// (Mirrored in shader.vert / shader.frag (lightPass): what one base-shader draw does)
+enum light_pass{
+  LightPass_Tiled,
+  LightPass_Unlit,
+  LightPass_Volume, // (Instanced: instance i covers light i)
+};
+
+// (Tiled culling: the internal screen is cut into LIGHT_TILE_SIZE squares and each tile lists the lights whose
+//  radius reaches it, so shader.frag loops over those only: per-pixel cost follows the lights overlapping a
+//  tile, not the scene's light count)
+#define LIGHT_TILE_SIZE 16 // (Mirrored in shader.frag)
+global_variable const uint32 LightTilesX = (InternalWidth + LIGHT_TILE_SIZE - 1) / LIGHT_TILE_SIZE;
+global_variable const uint32 LightTilesY = (InternalHeight + LIGHT_TILE_SIZE - 1) / LIGHT_TILE_SIZE;
+global_variable const uint32 LightTileCount = LightTilesX * LightTilesY;
+// (Tile list layout, one uint32 each (the R32UI texture buffer shader.frag reads): entries [2t, 2t + 1] are
+//  tile t's first index entry + light count, the light indices follow this header)
+global_variable const uint32 LIGHT_TILE_HEADER = 2 * LightTileCount;
+
+// (Bit k set: tile (TileX + k, TileY) overlaps the circle; SSE over four tiles of a row at a time: distance from
+//  the center to the nearest point of each tile rect against the radius. Tile rects are widened by MarginX on
+//  both sides, for a light that may sit up to MarginX off X)
+inline int LightTileMask4(real32 X, real32 Y, real32 RadiusSquared, uint32 TileX, uint32 TileY, real32 MarginX){
+  __m128 TileX0 = _mm_sub_ps(_mm_mul_ps(_mm_add_ps(_mm_set1_ps((real32)TileX), _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f)),
+					_mm_set1_ps((real32)LIGHT_TILE_SIZE)),
+			     _mm_set1_ps(MarginX));
+  __m128 TileX1 = _mm_add_ps(TileX0, _mm_set1_ps((real32)LIGHT_TILE_SIZE + (2.0f * MarginX)));
+  __m128 CenterX = _mm_set1_ps(X);
+  __m128 DX = _mm_max_ps(_mm_max_ps(_mm_sub_ps(TileX0, CenterX), _mm_sub_ps(CenterX, TileX1)), _mm_setzero_ps());
+
+  real32 TileY0 = (real32)(TileY * LIGHT_TILE_SIZE);
+  real32 TileY1 = TileY0 + LIGHT_TILE_SIZE;
+  real32 DY = (Y < TileY0) ? TileY0 - Y : (Y > TileY1) ? Y - TileY1 : 0.0f;
+
+  __m128 DistanceSquared = _mm_add_ps(_mm_mul_ps(DX, DX), _mm_set1_ps(DY * DY));
+  return _mm_movemask_ps(_mm_cmple_ps(DistanceSquared, _mm_set1_ps(RadiusSquared)));
+}
+
+// (CullLightTiles runs as a chain of jobs over ranges of LIGHT_CULL_JOB_LIGHTS lights: count per range, one
+//  prefix sum once every count is in, fill per range once the sum has placed each range's entries. Ranges
+//  keep their own per-tile counts, so no two jobs write the same word)
+#define LIGHT_CULL_JOB_LIGHTS 32
+#define LIGHT_CULL_MAX_JOBS 8 // (lighting_system::MAX_LIGHTS / LIGHT_CULL_JOB_LIGHTS)
+struct light_cull_job{
+  light_block_entry* Lights;
+  int32 Count;
+  real32 MarginX;
+  uint32* Entries;
+  uint32 Used;
+  // (Per range and tile: the range's light count, turned by the sum into where its next entry goes)
+  uint32 Cursors[LIGHT_CULL_MAX_JOBS][LightTileCount];
+};
+
+// (Pass 0: count each tile the lights [Begin, End) reach. Pass 1: append them to those tiles' lists)
+internal void BinLightTiles(light_cull_job* Job, uint32 Begin, uint32 End, int32 Pass){
+  uint32* Cursors = Job->Cursors[Begin / LIGHT_CULL_JOB_LIGHTS];
+  if(Pass == 0){ memset(Cursors, 0, sizeof(uint32) * LightTileCount); }
+  for(uint32 i = Begin; i < End; ++i){
+    real32 X = Job->Lights[i].Position[0];
+    real32 Y = Job->Lights[i].Position[1];
+    real32 Radius = Job->Lights[i].Radius;
+    int32 MinTileX = (int32)floorf((X - Radius - Job->MarginX) / LIGHT_TILE_SIZE);
+    int32 MaxTileX = (int32)floorf((X + Radius + Job->MarginX) / LIGHT_TILE_SIZE);
+    int32 MinTileY = (int32)floorf((Y - Radius) / LIGHT_TILE_SIZE);
+    int32 MaxTileY = (int32)floorf((Y + Radius) / LIGHT_TILE_SIZE);
+    if(MinTileX < 0){ MinTileX = 0; }
+    if(MinTileY < 0){ MinTileY = 0; }
+    if(MaxTileX > (int32)LightTilesX - 1){ MaxTileX = LightTilesX - 1; }
+    if(MaxTileY > (int32)LightTilesY - 1){ MaxTileY = LightTilesY - 1; }
+
+    for(int32 TileY = MinTileY; TileY <= MaxTileY; ++TileY){
+      for(int32 TileX = MinTileX; TileX <= MaxTileX; TileX += 4){
+	int Mask = LightTileMask4(X, Y, Radius * Radius, TileX, TileY, Job->MarginX);
+	for(int32 Lane = 0; Lane < 4 && TileX + Lane <= MaxTileX; ++Lane){
+	  if(!(Mask & (1 << Lane))){ continue; }
+	  uint32 Tile = (TileY * LightTilesX) + TileX + Lane;
+	  if(Pass == 0){ Cursors[Tile]++; }
+	  else{ Job->Entries[Cursors[Tile]++] = i; }
+	}
+      }
+    }
+  }
+}
+
+internal void CountLightTilesJob(void* Data, uint32 Begin, uint32 End){
+  BinLightTiles((light_cull_job*)Data, Begin, End, 0);
+}
+
+internal void FillLightTilesJob(void* Data, uint32 Begin, uint32 End){
+  BinLightTiles((light_cull_job*)Data, Begin, End, 1);
+}
+
+// (Counts -> header + cursors: each tile's list holds the ranges' entries one range after another, so the
+//  lights stay in order)
+internal void SumLightTilesJob(void* Data, uint32 Begin, uint32 End){
+  light_cull_job* Job = (light_cull_job*)Data;
+  uint32 RangeCount = (Job->Count + LIGHT_CULL_JOB_LIGHTS - 1) / LIGHT_CULL_JOB_LIGHTS;
+  uint32 Next = LIGHT_TILE_HEADER;
+  for(uint32 Tile = 0; Tile < LightTileCount; ++Tile){
+    uint32 First = Next;
+    for(uint32 Range = 0; Range < RangeCount; ++Range){
+      uint32 RangeLights = Job->Cursors[Range][Tile];
+      Job->Cursors[Range][Tile] = Next;
+      Next += RangeLights;
+    }
+    Job->Entries[2 * Tile] = First;
+    Job->Entries[(2 * Tile) + 1] = Next - First;
+  }
+  Job->Used = Next;
+}
+
+// (Bin Count lights into Entries (layout above), returns the entries used. Two passes over each light's tile
+//  bounds: count per tile, prefix-sum into the header, then fill, so every tile's list is contiguous and in
+//  light order, whichever workers ran the ranges)
+// (MarginX: how far the render side may shift the lights in X (lightShiftX in shader.frag): each light is
+//  binned into every tile it reaches from anywhere in that span)
+internal uint32 CullLightTiles(light_block_entry* Lights, int32 Count, uint32* Entries, real32 MarginX = 0.0f){
+  if(Count <= 0){
+    // (No ranges to queue, so nothing would hold the sum back or be waited on: write the empty header here)
+    for(uint32 Tile = 0; Tile < LightTileCount; ++Tile){
+      Entries[2 * Tile] = LIGHT_TILE_HEADER;
+      Entries[(2 * Tile) + 1] = 0;
+    }
+    return LIGHT_TILE_HEADER;
+  }
+  // (The whole chain is queued up front, each step held back by the previous one's counter)
+  light_cull_job Job;
+  Job.Lights = Lights;
+  Job.Count = Count;
+  Job.MarginX = MarginX;
+  Job.Entries = Entries;
+  job_counter Counted = {};
+  job_counter Summed = {};
+  job_counter Filled = {};
+  ParallelFor(&GlobalJobSystem, Count, LIGHT_CULL_JOB_LIGHTS, CountLightTilesJob, &Job, &Counted);
+  ParallelFor(&GlobalJobSystem, 1, 1, SumLightTilesJob, &Job, &Summed, &Counted);
+  ParallelFor(&GlobalJobSystem, Count, LIGHT_CULL_JOB_LIGHTS, FillLightTilesJob, &Job, &Filled, &Summed);
+  // (Job and the counters live in this frame: every step must be done before it returns)
+  WaitForJobs(&GlobalJobSystem, &Filled);
+  WaitForJobs(&GlobalJobSystem, &Summed);
+  WaitForJobs(&GlobalJobSystem, &Counted);
+  return Job.Used;
+}
+
+struct lighting_system{
+  static const int MAX_LIGHTS = 256; // (Mirrored in shader.frag: the LightBlock UBO stays under 16KB)
+  static const GLuint LIGHT_BLOCK_BINDING = 0;
+  static const uint32 MAX_TILE_ENTRIES = LIGHT_TILE_HEADER + (LightTileCount * MAX_LIGHTS);
+  light_source Lights[MAX_LIGHTS]; // (Dense: [0, ActiveLightCount) in use, addressed through handles)
+  int ActiveLightCount;
+  light_render_mode RenderMode; // (Sim side: captured per frame (render_frame::LightMode))
+
+  // (CPU copy of the uniform block: rebuilt on the sim side when Dirty, each rebuild a new BlockVersion;
+  //  frames carry a copy, and the render side re-sends it in one glBufferSubData only when the version moves)
+  // (Counts ahead of the lights, as in shader.frag: that one call covers the counts + the lights in use only)
+  struct light_uniform_block{
+    int32 NumActiveLights;
+    real32 AmbientStrength;
+    real32 Pad[2];
+    light_block_entry Lights[MAX_LIGHTS];
+  } UniformBlock;
+  GLuint LightUBO;
+  bool32 Dirty;
+  uint32 BlockVersion; // (Sim)
+  uint32 UploadedVersion; // (Render: the version LightUBO holds)
+
+  // (Per-tile light lists for the current block (see CullLightTiles): versioned with it)
+  // (CullMarginX: lights are placed for the sim step's camera, but the GPU scroll pass draws them at the camera
+  //  blended from the step before, up to one step's scroll away; the lists are built wide enough for that)
+  real32 CullMarginX;
+  uint32 TileEntries[MAX_TILE_ENTRIES];
+  uint32 TileEntryCount;
+  GLuint LightTileBuffer; // (Texture buffer storage, MAX_TILE_ENTRIES x R32UI)
+  GLuint LightTileTexture;
+
+  void InitGL(Shader* LightShader){
+    glGenBuffers(1, &LightUBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, LightUBO);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(UniformBlock), NULL, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, LIGHT_BLOCK_BINDING, LightUBO);
+    LightShader->BindUniformBlock("LightBlock", LIGHT_BLOCK_BINDING);
+
+    glGenBuffers(1, &LightTileBuffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, LightTileBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, sizeof(TileEntries), NULL, GL_DYNAMIC_DRAW);
+    glGenTextures(1, &LightTileTexture);
+    glBindTexture(GL_TEXTURE_BUFFER, LightTileTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_R32UI, LightTileBuffer);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    Dirty = true;
+  }
+
+  // (Handle pool: a light lives at Lights[Slots[Handle.Slot].DenseIndex] while the slot's generation still
+  //  matches the handle's. Live generations are odd, so the zero handle never matches)
+  light_slot Slots[MAX_LIGHTS];
+  uint32 DenseSlots[MAX_LIGHTS]; // (Lights[i] belongs to slot DenseSlots[i])
+  uint32 FreeSlots[MAX_LIGHTS]; // (Stack of released slots, reused before SlotsUsed grows)
+  uint32 FreeSlotCount;
+  uint32 SlotsUsed;
+
+  // (Zero handle if the pool is full)
+  light_handle AddLight(real32 PosX, real32 PosY, real32 R, real32 G,
+			real32 B, real32 Intensity, real32 Radius){
+    light_handle Handle = {};
+    if(ActiveLightCount >= MAX_LIGHTS){ return Handle; }
+    uint32 Slot = FreeSlotCount ? FreeSlots[--FreeSlotCount] : SlotsUsed++;
+    int idx = ActiveLightCount++;
+    Slots[Slot].Generation++;
+    Slots[Slot].DenseIndex = idx;
+    DenseSlots[idx] = Slot;
+
+    // (Copy aspects)
+    Lights[idx].PosX = PosX;
+    Lights[idx].PosY = PosY;
+    Lights[idx].R = R;
+    Lights[idx].G = G;
+    Lights[idx].B = B;
+    Lights[idx].Intensity = Intensity;
+    Lights[idx].Radius = Radius;
+    Dirty = true;
+
+    Handle.Slot = Slot;
+    Handle.Generation = Slots[Slot].Generation;
+    return Handle;
+  }
+
+  // (0 once Handle's light has been removed)
+  light_source* GetLight(light_handle Handle){
+    if(Handle.Slot >= SlotsUsed || Slots[Handle.Slot].Generation != Handle.Generation){ return 0; }
+    return &Lights[Slots[Handle.Slot].DenseIndex];
+  }
+
+  void MoveLight(light_handle Handle, real32 PosX, real32 PosY){
+    light_source* Light = GetLight(Handle);
+    if(!Light){ return; }
+    Light->PosX = PosX;
+    Light->PosY = PosY;
+    Dirty = true;
+  }
+
+  // (Swap-remove: the last light fills the hole and its slot is remapped, so Lights stays dense)
+  void RemoveLight(light_handle Handle){
+    if(!GetLight(Handle)){ return; }
+    int32 Hole = Slots[Handle.Slot].DenseIndex;
+    int32 Last = --ActiveLightCount;
+    Lights[Hole] = Lights[Last];
+    DenseSlots[Hole] = DenseSlots[Last];
+    Slots[DenseSlots[Hole]].DenseIndex = Hole;
+
+    Slots[Handle.Slot].Generation++;
+    FreeSlots[FreeSlotCount++] = Handle.Slot;
+    Dirty = true;
+  }
+
+  void SetCullMargin(real32 MarginX){
+    if(MarginX == CullMarginX){ return; }
+    CullMarginX = MarginX;
+    Dirty = true;
+  }
+
+  void ClearLights(){
+    for(int32 i = 0; i < ActiveLightCount; ++i){
+      Slots[DenseSlots[i]].Generation++;
+      FreeSlots[FreeSlotCount++] = DenseSlots[i];
+    }
+    ActiveLightCount = 0;
+    Dirty = true;
+  }
+
+  // (Sim side: rebuild the block, only if a light changed since the last call)
+  void UpdateLightBlock(){
+    TIMED_BLOCK(UpdateLightUniforms);
+    if(!Dirty){ return; }
+
+    // (Lights is dense: the block's first ActiveLightCount entries are all there is to write)
+    UniformBlock.NumActiveLights = ActiveLightCount;
+    UniformBlock.AmbientStrength = 0.2f;
+    
+    for(int i = 0; i < ActiveLightCount; ++i){
+      light_block_entry* Entry = &UniformBlock.Lights[i];
+      Entry->Color[0] = Lights[i].R;
+      Entry->Color[1] = Lights[i].G;
+      Entry->Color[2] = Lights[i].B;
+      Entry->Intensity = Lights[i].Intensity;
+      Entry->Position[0] = Lights[i].PosX;
+      Entry->Position[1] = Lights[i].PosY;
+      Entry->Radius = Lights[i].Radius;
+      Entry->Pad = 0.0f;
+    }
+    TileEntryCount = CullLightTiles(UniformBlock.Lights, ActiveLightCount, TileEntries, CullMarginX);
+    BlockVersion++;
+    Dirty = false;
+  }
+
+  // (Sim side: copy the current block into a frame's, O(active) like the upload)
+  void CopyLightBlock(light_uniform_block* Dest){
+    memcpy(Dest->Lights, UniformBlock.Lights, sizeof(light_block_entry) * UniformBlock.NumActiveLights);
+    Dest->NumActiveLights = UniformBlock.NumActiveLights;
+    Dest->AmbientStrength = UniformBlock.AmbientStrength;
+  }
+
+  // (Render side: upload a frame's copy of the block + tile lists if it is newer than what the GPU holds)
+  void UploadLightBlock(light_uniform_block* Block, uint32* Tiles, uint32 TileCount, uint32 Version){
+    if(Version == UploadedVersion){ return; }
+    // (Counts + the lights in use: entries past NumActiveLights are never indexed)
+    glBindBuffer(GL_UNIFORM_BUFFER, LightUBO);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0,
+		    offsetof(light_uniform_block, Lights) + (sizeof(light_block_entry) * Block->NumActiveLights), Block);
+    glBindBuffer(GL_TEXTURE_BUFFER, LightTileBuffer);
+    glBufferSubData(GL_TEXTURE_BUFFER, 0, sizeof(uint32) * TileCount, Tiles);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    UploadedVersion = Version;
+  }
+};
+static_assert(offsetof(lighting_system::light_uniform_block, Lights) == 16, "LightBlock's lights start at std140 offset 16");
+static_assert(lighting_system::MAX_LIGHTS <= LIGHT_CULL_MAX_JOBS * LIGHT_CULL_JOB_LIGHTS, "light culling needs a range per LIGHT_CULL_JOB_LIGHTS lights");
+global_variable lighting_system GlobalLightingSystem;
+
+#define LIGHTING_H
+#endif
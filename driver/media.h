@@ -13,7 +13,7 @@ internal void LoadGameMap(game_map* GameMap, char* Filename){
       for(int i = 0; i < Height; ++i){
 	for(int j = 0; j < Width; ++j){
 	  int SrcIndex = (i * Width + j) * 4;
-	  int DstIndex = IX(i,j);
+	  int DstIndex = MX(ScreenRowFromMapRow(i), j); // (Row-major, flipped to GL row order)
 
 	  uint32 CurrentColor = 
 	    (PixelBuffer[SrcIndex + 0] << 24) | // Red
@@ -53,6 +53,39 @@ internal void LoadSpriteMap(sprite_map* SpriteMap, char* Filename){
   }
 }
 
+// (Biased unorm byte for a normal component in [-1, 1]: shader.frag decodes with one multiply-add)
+inline uint32 PackNormalComponent(real32 Value){
+  return (uint32)(((Value * 0.5f) + 0.5f) * 255.0f + 0.5f);
+}
+
+// (Where a normal map's angles become normals: mirrored in shader.frag (normalDecode))
+enum normal_decode{
+  NormalDecode_Load, // (Once per texel, here at load: the shader only unbiases)
+  NormalDecode_Trig, // (Per lit pixel in shader.frag, from the raw angle bytes: kept to compare against)
+
+  NormalDecode_Count
+};
+global_variable char* NormalDecodeNames[NormalDecode_Count] = {
+  "load",
+  "trig",
+};
+// (Read at scene load (LoadScenePNGs): a scene keeps the decode it was loaded with (game_map::NormalDecode))
+global_variable normal_decode GlobalNormalDecode = NormalDecode_Load;
+
+// (Normal map texel: the image encodes each surface's angle as R + G degrees and its material flags in alpha.
+//  NormalDecode_Load decodes it here, once per texel, into R, G = surface normal (PackNormalComponent), B
+//  unused, A = flags, so the lighting pass reads a ready normal in the same fetch as the flags instead of
+//  running trig per pixel. NormalDecode_Trig keeps the raw R, G angle bytes)
+inline uint32 DecodeNormalTexel(uint8 Red, uint8 Green, uint8 Alpha, normal_decode Decode){
+  if(Decode == NormalDecode_Trig){
+    return (Red << 24) | (Green << 16) | Alpha;
+  }
+  real32 AngleRadians = (real32)(Red + Green) * (3.14159265f / 180.0f);
+  return (PackNormalComponent(cosf(AngleRadians)) << 24) |
+    (PackNormalComponent(sinf(AngleRadians)) << 16) |
+    Alpha;
+}
+
 internal void LoadNormalMap(game_map* GameMap, char* Filename){
   int Width, Height, Channels;
   
@@ -62,20 +95,12 @@ internal void LoadNormalMap(game_map* GameMap, char* Filename){
       for(int i = 0; i < Height; ++i){
 	for(int j = 0; j < Width; ++j){
 	  int SrcIndex = (i * Width + j) * 4;
-	  int DstIndex = IX(i,j);
+	  int DstIndex = MX(ScreenRowFromMapRow(i), j); // (Row-major, flipped to GL row order)
 
-	  /* 
-	  uint32 CurrentAngle =
-	    (ValueBuffer[SrcIndex + 0]) + // Red
-	    (ValueBuffer[SrcIndex + 1]); // Green
-	  */
-	  // (We'll conver to angle in OpenGL)
-	  uint32 CurrentAngle =
-	    (ValueBuffer[SrcIndex + 0] << 24) | // Red
-	    (ValueBuffer[SrcIndex + 1] << 16) | // Green
-	    (ValueBuffer[SrcIndex + 3]); // Alpha 
-	  
-	  GameMap->Angles[DstIndex] = CurrentAngle;
+	  GameMap->Angles[DstIndex] = DecodeNormalTexel(ValueBuffer[SrcIndex + 0], // Red
+							ValueBuffer[SrcIndex + 1], // Green
+							ValueBuffer[SrcIndex + 3], // Alpha
+							(normal_decode)GameMap->NormalDecode);
 	}}
     }
     stbi_image_free(ValueBuffer);
@@ -0,0 +1,115 @@
+#if !defined(NULL_GL_H)
+
+// (No-op OpenGL backend for headless runs (bench.cpp))
+// (Every GL entry point still goes through GLAD's function pointers, so the CPU-side cost of
+//  building + submitting data is measured while the GPU work itself is skipped)
+
+struct null_gl_stats{
+  uint64 BufferBytesUploaded; // (glBufferData / glBufferSubData)
+  uint64 TextureBytesUploaded; // (glTexImage2D / glTexSubImage2D, assuming 4 bytes per texel)
+  uint64 BufferBytesMapped; // (glMapBufferRange: bytes handed out for writing)
+  uint64 UniformCalls;
+  uint64 DrawCalls;
+};
+global_variable null_gl_stats GlobalNullGLStats;
+global_variable GLuint NullGLNextObject = 1;
+
+// (Catch-all: returns 0 for any integer/pointer-returning entry point we don't model)
+static void* APIENTRY NullGLNoOp(){ return 0; }
+
+static const GLubyte* APIENTRY NullGLGetString(GLenum Name){
+  if(Name == GL_VERSION){ return (const GLubyte*)"3.3.0 NullGL"; }
+  return (const GLubyte*)"";
+}
+
+static void APIENTRY NullGLGetIntegerv(GLenum Name, GLint* Data){ *Data = 0; }
+
+static void APIENTRY NullGLGetObjectiv(GLuint Object, GLenum Name, GLint* Params){
+  // (Report successful compiles / links, nothing else)
+  *Params = (Name == GL_COMPILE_STATUS || Name == GL_LINK_STATUS) ? 1 : 0;
+}
+
+static void APIENTRY NullGLGenObjects(GLsizei Count, GLuint* Objects){
+  for(int i = 0; i < Count; ++i){ Objects[i] = NullGLNextObject++; }
+}
+
+static GLuint APIENTRY NullGLCreateObject(){ return NullGLNextObject++; }
+
+static void APIENTRY NullGLBufferData(GLenum Target, GLsizeiptr Size, const void* Data, GLenum Usage){
+  GlobalNullGLStats.BufferBytesUploaded += Size;
+}
+
+static void APIENTRY NullGLBufferSubData(GLenum Target, GLintptr Offset, GLsizeiptr Size, const void* Data){
+  GlobalNullGLStats.BufferBytesUploaded += Size;
+}
+
+// (Scratch block standing in for driver memory: contents are never read back)
+static void* APIENTRY NullGLMapBufferRange(GLenum Target, GLintptr Offset, GLsizeiptr Length, GLbitfield Access){
+  static uint8* Scratch = 0;
+  static GLsizeiptr ScratchSize = 0;
+  if(Length > ScratchSize){
+    Scratch = (uint8*)realloc(Scratch, Length);
+    ScratchSize = Length;
+  }
+  GlobalNullGLStats.BufferBytesMapped += Length;
+  return Scratch;
+}
+
+static GLboolean APIENTRY NullGLUnmapBuffer(GLenum Target){ return GL_TRUE; }
+
+static void APIENTRY NullGLTexImage2D(GLenum Target, GLint Level, GLint InternalFormat, GLsizei Width, GLsizei Height,
+				       GLint Border, GLenum Format, GLenum Type, const void* Pixels){
+  GlobalNullGLStats.TextureBytesUploaded += (uint64)Width * Height * 4;
+}
+
+static void APIENTRY NullGLTexSubImage2D(GLenum Target, GLint Level, GLint XOffset, GLint YOffset,
+					  GLsizei Width, GLsizei Height, GLenum Format, GLenum Type, const void* Pixels){
+  GlobalNullGLStats.TextureBytesUploaded += (uint64)Width * Height * 4;
+}
+
+static void APIENTRY NullGLUniform(){ GlobalNullGLStats.UniformCalls++; }
+static void APIENTRY NullGLDraw(){ GlobalNullGLStats.DrawCalls++; }
+
+// (GLADloadproc: resolve names to the stubs above)
+static void* NullGLGetProcAddress(const char* Name){
+  struct null_gl_entry{ char* Name; void* Proc; };
+  static null_gl_entry Entries[] = {
+    {"glGetString", (void*)NullGLGetString},
+    {"glGetIntegerv", (void*)NullGLGetIntegerv},
+    {"glGetShaderiv", (void*)NullGLGetObjectiv},
+    {"glGetProgramiv", (void*)NullGLGetObjectiv},
+    {"glGenBuffers", (void*)NullGLGenObjects},
+    {"glGenTextures", (void*)NullGLGenObjects},
+    {"glGenVertexArrays", (void*)NullGLGenObjects},
+    {"glCreateShader", (void*)NullGLCreateObject},
+    {"glCreateProgram", (void*)NullGLCreateObject},
+    {"glBufferData", (void*)NullGLBufferData},
+    {"glBufferSubData", (void*)NullGLBufferSubData},
+    {"glMapBufferRange", (void*)NullGLMapBufferRange},
+    {"glUnmapBuffer", (void*)NullGLUnmapBuffer},
+    {"glTexImage2D", (void*)NullGLTexImage2D},
+    {"glTexSubImage2D", (void*)NullGLTexSubImage2D},
+    {"glUniform1i", (void*)NullGLUniform},
+    {"glUniform1f", (void*)NullGLUniform},
+    {"glUniform2f", (void*)NullGLUniform},
+    {"glUniform2i", (void*)NullGLUniform},
+    {"glUniform3f", (void*)NullGLUniform},
+    {"glDrawElements", (void*)NullGLDraw},
+    {"glDrawElementsInstanced", (void*)NullGLDraw},
+    {"glDrawArraysInstanced", (void*)NullGLDraw},
+    {"glDrawArrays", (void*)NullGLDraw},
+  };
+  for(int i = 0; i < ArrayCount(Entries); ++i){
+    if(strcmp(Entries[i].Name, Name) == 0){ return Entries[i].Proc; }
+  }
+  return (void*)NullGLNoOp;
+}
+
+// (Returns non-zero once every GLAD pointer resolves to a stub)
+internal int32 NullGLInit(){
+  gladLoadGLLoader(NullGLGetProcAddress); // (extension probing fails under the null backend: ignore result)
+  return glGetString != 0 && glBufferData != 0;
+}
+
+#define NULL_GL_H
+#endif
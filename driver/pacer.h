@@ -0,0 +1,136 @@
+#if !defined(PACER_H)
+
+// (Frame pacing: how the render thread waits out each GlobalRenderHz tick, plus a histogram of how far every
+//  presented interval landed from its target, so strategies can be compared per machine (F5 in game cycles
+//  them, F1 reports; ./bench -mode pacing runs the non-display ones headless))
+
+#if defined(_MSC_VER)
+#include <intrin.h> // (_mm_pause)
+#else
+#include <immintrin.h> // (_mm_pause)
+#endif
+
+enum frame_pace_strategy{
+  FramePace_VSync, // (SwapBuffers blocks on the display's refresh: no wait of our own)
+  FramePace_Timer, // (High-resolution timer sleep up to FRAME_PACE_SPIN_TAIL before the deadline, spin the rest)
+  FramePace_BusyWait, // (Spin on the clock the whole way: tightest, burns the core)
+
+  FramePace_Count
+};
+global_variable char* FramePaceStrategyNames[FramePace_Count] = {
+  "vsync",
+  "timer",
+  "busy",
+};
+
+// (Timer wakeups can land this late: the remainder is spun)
+global_variable const real64 FRAME_PACE_SPIN_TAIL = 0.0015;
+
+// (Interval error |interval - target| in 1us buckets; the last one collects everything beyond)
+#define FRAME_PACE_BUCKETS 4096
+
+struct frame_pacer{
+  frame_pace_strategy Strategy;
+  real64 TargetInterval; // (Seconds per presented frame)
+  real64 NextDeadline; // (PlatformGetWallClockSeconds)
+  real64 LastPresent; // (0: nothing presented since FramePacerReset)
+
+  // (Stats since FramePacerReset)
+  uint32 Histogram[FRAME_PACE_BUCKETS];
+  uint64 IntervalCount;
+  real64 IntervalTotal; // (Seconds)
+  real64 MaxError; // (Seconds)
+  real64 StartTime; // (Wall / thread CPU seconds at the first present: CPU share of the time since)
+  real64 StartCPUTime;
+};
+
+// (Clear the stats and restart the schedule from Now: strategy / rate changes shouldn't skew the histogram)
+internal void FramePacerReset(frame_pacer* Pacer, frame_pace_strategy Strategy, real64 TargetHz, real64 Now){
+  memset(Pacer, 0, sizeof(*Pacer));
+  Pacer->Strategy = Strategy;
+  Pacer->TargetInterval = 1.0 / TargetHz;
+  Pacer->NextDeadline = Now + Pacer->TargetInterval;
+}
+
+// (Return at Deadline, by Strategy: also used to pace the sim, where vsync has nothing to wait on (timer))
+internal void PaceWaitUntil(frame_pace_strategy Strategy, real64 Deadline){
+  if(Strategy == FramePace_VSync){ Strategy = FramePace_Timer; }
+  real64 Now = PlatformGetWallClockSeconds();
+  if(Strategy == FramePace_Timer && Deadline - Now > FRAME_PACE_SPIN_TAIL){
+    PlatformTimerWait((Deadline - Now) - FRAME_PACE_SPIN_TAIL);
+    Now = PlatformGetWallClockSeconds();
+  }
+  while(Now < Deadline){
+    _mm_pause();
+    Now = PlatformGetWallClockSeconds();
+  }
+}
+
+// (Render side, before presenting: wait out the current tick unless the swap itself will)
+internal void FramePacerWait(frame_pacer* Pacer){
+  if(Pacer->Strategy != FramePace_VSync){
+    PaceWaitUntil(Pacer->Strategy, Pacer->NextDeadline);
+  }
+}
+
+// (Render side, right after presenting: record the interval and schedule the next deadline. A late frame
+//  resyncs the schedule instead of bunching up the following ones to catch up)
+internal void FramePacerPresented(frame_pacer* Pacer){
+  real64 Now = PlatformGetWallClockSeconds();
+  if(Pacer->LastPresent > 0.0){
+    real64 Interval = Now - Pacer->LastPresent;
+    real64 Error = fabs(Interval - Pacer->TargetInterval);
+    uint32 Bucket = (uint32)(Error * 1e6);
+    if(Bucket >= FRAME_PACE_BUCKETS){ Bucket = FRAME_PACE_BUCKETS - 1; }
+    Pacer->Histogram[Bucket]++;
+    Pacer->IntervalCount++;
+    Pacer->IntervalTotal += Interval;
+    if(Error > Pacer->MaxError){ Pacer->MaxError = Error; }
+  }
+  else{
+    Pacer->StartTime = Now;
+    Pacer->StartCPUTime = PlatformGetThreadCPUSeconds();
+  }
+  Pacer->LastPresent = Now;
+
+  Pacer->NextDeadline += Pacer->TargetInterval;
+  if(Pacer->NextDeadline < Now){ Pacer->NextDeadline = Now + Pacer->TargetInterval; }
+}
+
+// (Interval error at or below which Fraction of the intervals fell, in microseconds (bucket upper edge))
+internal real64 FramePacerPercentileUS(frame_pacer* Pacer, real64 Fraction){
+  if(!Pacer->IntervalCount){ return 0.0; }
+  uint64 Rank = (uint64)ceil(Fraction * Pacer->IntervalCount);
+  if(Rank < 1){ Rank = 1; }
+  uint64 Seen = 0;
+  for(uint32 Bucket = 0; Bucket < FRAME_PACE_BUCKETS; ++Bucket){
+    Seen += Pacer->Histogram[Bucket];
+    if(Seen >= Rank){
+      // (The overflow bucket has no upper edge: the worst error seen stands in)
+      return (Bucket == FRAME_PACE_BUCKETS - 1) ? Pacer->MaxError * 1e6 : (real64)(Bucket + 1);
+    }
+  }
+  return Pacer->MaxError * 1e6;
+}
+
+// (Share of the wall time since the first present this thread spent on a CPU (waiting included))
+internal real64 FramePacerCPUShare(frame_pacer* Pacer){
+  real64 Wall = Pacer->LastPresent - Pacer->StartTime;
+  if(Wall <= 0.0){ return 0.0; }
+  return (PlatformGetThreadCPUSeconds() - Pacer->StartCPUTime) / Wall;
+}
+
+// (Human-readable dump through PlatformOutputDebugString, next to ProfileReport)
+internal void FramePacerReport(frame_pacer* Pacer){
+  char Buffer[256];
+  if(!Pacer->IntervalCount){ return; }
+  sprintf(Buffer, "Pacing (%s, target %.3fms): %llu intervals, mean %.3fms --- error p50 %.0fus --- p99 %.0fus --- p99.9 %.0fus --- max %.0fus --- cpu %.0f%%\n",
+	  FramePaceStrategyNames[Pacer->Strategy], Pacer->TargetInterval * 1e3,
+	  (unsigned long long)Pacer->IntervalCount, (Pacer->IntervalTotal / Pacer->IntervalCount) * 1e3,
+	  FramePacerPercentileUS(Pacer, 0.5), FramePacerPercentileUS(Pacer, 0.99), FramePacerPercentileUS(Pacer, 0.999),
+	  Pacer->MaxError * 1e6, FramePacerCPUShare(Pacer) * 100.0);
+  PlatformOutputDebugString(Buffer);
+}
+
+#define PACER_H
+#endif
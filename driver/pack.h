@@ -0,0 +1,201 @@
+#if !defined(PACK_H)
+
+// (Scene pack: a scene cooked offline (./bench -mode cook) into one file already in the runtime layout, so
+//  loading is a file mapping plus pointer fixups: no PNG decode, no per-pixel repacking, no copies)
+// (Layout: scene_pack_header, then one section per scene_pack_section_type, each starting on a
+//  SCENE_PACK_ALIGNMENT boundary)
+// (Map pixels / normals: Width x InternalHeight, chunk-major: WorldChunkCount(Width) chunks in the world.h
+//  layout, as LoadGameMap / LoadNormalMap leave the texels (normals decoded by DecodeNormalTexel). Never
+//  touched through the mapping: the world streamer reads the chunks it needs from the file. Sprite pixels:
+//  SpriteMapWidth x SpriteMapHeight uint32; emitters: light_emitter[], sorted by MapX, as IndexLightEmitters
+//  leaves them)
+
+#define SCENE_PACK_MAGIC 0x4B50574E // ('NWPK')
+#define SCENE_PACK_VERSION 2
+#define SCENE_PACK_ALIGNMENT 4096 // (Page: every section maps in on its own pages)
+
+enum scene_pack_section_type{
+  ScenePack_MapPixels,
+  ScenePack_MapNormals,
+  ScenePack_SpritePixels,
+  ScenePack_Emitters,
+
+  ScenePack_SectionCount
+};
+
+struct scene_pack_section{
+  uint32 Width; // (Emitters: count)
+  uint32 Height; // (Emitters: 1)
+  uint64 Offset; // (From the start of the file)
+  uint64 Size;
+};
+
+struct scene_pack_header{
+  uint32 Magic;
+  uint32 Version;
+  uint32 EmitterSize; // (sizeof(light_emitter) when cooked: a layout change invalidates the pack)
+  uint32 ChunkWidth; // (WORLD_CHUNK_WIDTH when cooked: likewise)
+  scene_pack_section Sections[ScenePack_SectionCount];
+};
+
+// (Bytes of a map section Width columns wide: whole chunks)
+inline uint64 ScenePackMapSize(uint32 Width){
+  return (uint64)WorldChunkCount(Width) * WorldChunkTexels * sizeof(uint32);
+}
+
+// (Section Type of the mapped Pack if it is Width x Height elements, Size bytes, inside the file, else 0)
+internal void* ScenePackSection(mapped_file* Pack, scene_pack_section_type Type, uint32 Width, uint32 Height, uint64 Size){
+  scene_pack_header* Header = (scene_pack_header*)Pack->Memory;
+  scene_pack_section* Section = &Header->Sections[Type];
+  if(Section->Width != Width || Section->Height != Height){ return 0; }
+  if(Section->Size != Size){ return 0; }
+  if(Section->Offset % SCENE_PACK_ALIGNMENT || Section->Offset > Pack->Size || Section->Size > Pack->Size - Section->Offset){ return 0; }
+  return (uint8*)Pack->Memory + Section->Offset;
+}
+
+// (Point GameMap / SpriteMap straight into a mapping of Filename, map chunks to be read from it as the world
+//  streamer needs them. False, with nothing changed, if the file is missing or doesn't match this build's
+//  layout: the caller falls back to the PNGs)
+internal bool32 LoadScenePack(game_map* GameMap, sprite_map* SpriteMap, char* Filename){
+  mapped_file Pack = PlatformMapFile(Filename);
+  if(!Pack.Memory){ return false; }
+
+  scene_pack_header* Header = (scene_pack_header*)Pack.Memory;
+  void* MapPixels = 0;
+  void* MapNormals = 0;
+  void* SpritePixels = 0;
+  void* Emitters = 0;
+  void* PackFile = 0;
+  uint32 Width = 0;
+  if(Pack.Size >= sizeof(scene_pack_header) && Header->Magic == SCENE_PACK_MAGIC && Header->Version == SCENE_PACK_VERSION &&
+     Header->EmitterSize == sizeof(light_emitter) && Header->ChunkWidth == WORLD_CHUNK_WIDTH){
+    Width = Header->Sections[ScenePack_MapPixels].Width;
+    if(Width >= InternalWidth){
+      MapPixels = ScenePackSection(&Pack, ScenePack_MapPixels, Width, InternalHeight, ScenePackMapSize(Width));
+      MapNormals = ScenePackSection(&Pack, ScenePack_MapNormals, Width, InternalHeight, ScenePackMapSize(Width));
+    }
+    SpritePixels = ScenePackSection(&Pack, ScenePack_SpritePixels, SpriteMapWidth, SpriteMapHeight,
+				    (uint64)SpriteMapWidth * SpriteMapHeight * sizeof(uint32));
+    uint32 EmitterCount = Header->Sections[ScenePack_Emitters].Width;
+    Emitters = ScenePackSection(&Pack, ScenePack_Emitters, EmitterCount, 1, (uint64)EmitterCount * sizeof(light_emitter));
+  }
+  if(MapPixels && MapNormals && SpritePixels && Emitters){
+    PackFile = PlatformOpenFileForReading(Filename);
+  }
+  if(!PackFile){
+    PlatformOutputDebugString("Scene pack missing or out of date: loading PNGs\n");
+    PlatformUnmapFile(&Pack);
+    return false;
+  }
+
+  // (Mapped copy-on-write: the emitters' light handles are written in place without touching the file)
+  GameMap->Pack = Pack;
+  GameMap->PackFile = PackFile;
+  GameMap->NormalDecode = NormalDecode_Load;
+  GameMap->PackPixelsOffset = Header->Sections[ScenePack_MapPixels].Offset;
+  GameMap->PackAnglesOffset = Header->Sections[ScenePack_MapNormals].Offset;
+  GameMap->Pixels = 0;
+  GameMap->Angles = 0;
+  GameMap->Width = (int32)Width;
+  GameMap->ChunkCount = WorldChunkCount(Width);
+  GameMap->Emitters = (light_emitter*)Emitters;
+  GameMap->EmitterCount = Header->Sections[ScenePack_Emitters].Width;
+  GameMap->MaxEmitterRadius = 0.0f;
+  for(int32 i = 0; i < GameMap->EmitterCount; ++i){
+    if(GameMap->Emitters[i].Radius > GameMap->MaxEmitterRadius){ GameMap->MaxEmitterRadius = GameMap->Emitters[i].Radius; }
+  }
+  GameMap->StreamedFirst = GameMap->StreamedLast = 0;
+  GameMap->StreamedXOffset = -1;
+  SpriteMap->Pixels = (uint32*)SpritePixels;
+  return true;
+}
+
+// (Cooker side: copy the WORLD_CHUNK_WIDTH columns from X0 on of a world that repeats Source (Width columns)
+//  up to WorldWidth into Chunk, one map row after another (world.h layout))
+internal void CookWorldChunk(uint32* Source, int32 Width, int32 WorldWidth, int32 X0, uint32* Chunk){
+  for(int32 Row = 0; Row < (int32)InternalHeight; ++Row){
+    uint32* Dest = &Chunk[Row * WORLD_CHUNK_WIDTH];
+    for(int32 Column = 0; Column < WORLD_CHUNK_WIDTH;){
+      int32 X = X0 + Column;
+      if(X >= WorldWidth){
+	memset(&Dest[Column], 0, (WORLD_CHUNK_WIDTH - Column) * sizeof(uint32));
+	break;
+      }
+      int32 SourceX = X % Width;
+      int32 Run = WORLD_CHUNK_WIDTH - Column;
+      if(Run > Width - SourceX){ Run = Width - SourceX; }
+      if(Run > WorldWidth - X){ Run = WorldWidth - X; }
+      memcpy(&Dest[Column], &Source[(Row * Width) + SourceX], Run * sizeof(uint32));
+      Column += Run;
+    }
+  }
+}
+
+// (Cooker side: write GameMap / SpriteMap (loaded from the PNGs, emitters indexed) to Filename as a world
+//  WorldWidth columns wide: the scene repeats across it, emitters included (WorldWidth = GameMap->Width: the
+//  scene as is))
+internal bool32 WriteScenePack(game_map* GameMap, sprite_map* SpriteMap, int32 WorldWidth, char* Filename){
+  scene_pack_header Header = {};
+  Header.Magic = SCENE_PACK_MAGIC;
+  Header.Version = SCENE_PACK_VERSION;
+  Header.EmitterSize = sizeof(light_emitter);
+  Header.ChunkWidth = WORLD_CHUNK_WIDTH;
+
+  // (Emitters are cooked unlit: handles belong to a running lighting_system)
+  int32 Repeats = (WorldWidth + GameMap->Width - 1) / GameMap->Width;
+  light_emitter* Emitters = (light_emitter*)PlatformAllocateMemory(sizeof(light_emitter) * (GameMap->EmitterCount * Repeats + 1));
+  uint32 EmitterCount = 0;
+  for(int32 Repeat = 0; Repeat < Repeats; ++Repeat){
+    for(int32 i = 0; i < GameMap->EmitterCount; ++i){
+      light_emitter Emitter = GameMap->Emitters[i];
+      Emitter.MapX += Repeat * GameMap->Width;
+      Emitter.Light = {};
+      if(Emitter.MapX < WorldWidth){ Emitters[EmitterCount++] = Emitter; }
+    }
+  }
+
+  // (Map sections are written chunk by chunk below, so a world of any width cooks through one chunk of memory)
+  void* Sources[ScenePack_SectionCount] = { 0, 0, SpriteMap->Pixels, Emitters };
+  uint32 Widths[ScenePack_SectionCount] = { (uint32)WorldWidth, (uint32)WorldWidth, SpriteMapWidth, EmitterCount };
+  uint32 Heights[ScenePack_SectionCount] = { InternalHeight, InternalHeight, SpriteMapHeight, 1 };
+  uint64 Sizes[ScenePack_SectionCount] = { ScenePackMapSize(WorldWidth), ScenePackMapSize(WorldWidth),
+					   (uint64)SpriteMapWidth * SpriteMapHeight * sizeof(uint32),
+					   (uint64)EmitterCount * sizeof(light_emitter) };
+  uint64 Offset = SCENE_PACK_ALIGNMENT;
+  for(uint32 i = 0; i < ScenePack_SectionCount; ++i){
+    Header.Sections[i].Width = Widths[i];
+    Header.Sections[i].Height = Heights[i];
+    Header.Sections[i].Offset = Offset;
+    Header.Sections[i].Size = Sizes[i];
+    Offset += (Header.Sections[i].Size + SCENE_PACK_ALIGNMENT - 1) & ~(uint64)(SCENE_PACK_ALIGNMENT - 1);
+  }
+
+  uint32* Chunk = (uint32*)PlatformAllocateMemory(WorldChunkTexels * sizeof(uint32));
+  bool32 Written = false;
+  FILE* File = fopen(Filename, "wb");
+  if(File){
+    static const uint8 Zeroes[SCENE_PACK_ALIGNMENT] = {};
+    Written = (fwrite(&Header, sizeof(Header), 1, File) == 1);
+    uint64 At = sizeof(Header);
+    for(uint32 i = 0; i < ScenePack_SectionCount && Written; ++i){
+      scene_pack_section* Section = &Header.Sections[i];
+      Written = (fwrite(Zeroes, 1, Section->Offset - At, File) == Section->Offset - At);
+      if(i == ScenePack_MapPixels || i == ScenePack_MapNormals){
+	uint32* Source = (i == ScenePack_MapPixels) ? GameMap->Pixels : GameMap->Angles;
+	for(int32 X0 = 0; X0 < WorldWidth && Written; X0 += WORLD_CHUNK_WIDTH){
+	  CookWorldChunk(Source, GameMap->Width, WorldWidth, X0, Chunk);
+	  Written = (fwrite(Chunk, WorldChunkTexels * sizeof(uint32), 1, File) == 1);
+	}
+      }
+      else if(Written && Section->Size){ Written = (fwrite(Sources[i], Section->Size, 1, File) == 1); }
+      At = Section->Offset + Section->Size;
+    }
+    if(fclose(File) != 0){ Written = false; }
+  }
+  PlatformFreeMemory(Chunk);
+  PlatformFreeMemory(Emitters);
+  return Written;
+}
+
+#define PACK_H
+#endif
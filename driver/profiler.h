@@ -0,0 +1,210 @@
+#if !defined(PROFILER_H)
+
+// (Scoped rdtsc hot-path profiler)
+// (TIMED_BLOCK(Name) adds the scope's cycles to the current frame's record in a fixed ring;
+//  nothing is allocated or formatted per frame. ProfileSummarize / ProfileReport aggregate on demand)
+// (One ring per thread that frames it: sim steps and render ticks run at their own rates. Each block belongs to
+//  one ring (ProfileBlockRings), and only that ring's thread begins, ends and reports its frames. Adds are
+//  atomic, for blocks closed by job workers inside the owning thread's frame)
+
+#if defined(_MSC_VER)
+#include <intrin.h> // (__rdtsc)
+#else
+#include <x86intrin.h> // (__rdtsc)
+#endif
+
+// (Compile out with -DPROFILER=0)
+#if !defined(PROFILER)
+#define PROFILER 1
+#endif
+
+#define ReadCPUTimer() __rdtsc()
+
+enum profile_block_id{
+  ProfileBlock_LoadInternalMap,
+  ProfileBlock_ProcessGameInput,
+  ProfileBlock_WASAPI,
+  ProfileBlock_RainUpdate,
+  ProfileBlock_StreamLights,
+  ProfileBlock_StreamChunks,
+  ProfileBlock_UpdateLightUniforms,
+  ProfileBlock_BaseTexturePass,
+  ProfileBlock_RainPass,
+  ProfileBlock_SwapBuffers,
+  ProfileBlock_FrameWait,
+  ProfileBlock_RenderWait,
+
+  ProfileBlock_Count
+};
+global_variable char* ProfileBlockNames[ProfileBlock_Count] = {
+  "LoadInternalMap",
+  "ProcessGameInput",
+  "WASAPI",
+  "RainUpdate",
+  "StreamLights",
+  "StreamChunks",
+  "UpdateLightUniforms",
+  "BaseTexturePass",
+  "RainPass",
+  "SwapBuffers",
+  "FrameWait",
+  "RenderWait",
+};
+
+enum profile_ring_id{
+  ProfileRing_Sim, // (Main thread: one frame per pass of the game loop)
+  ProfileRing_Render, // (Render thread: one frame per render tick)
+
+  ProfileRing_Count
+};
+global_variable char* ProfileRingNames[ProfileRing_Count] = {
+  "sim",
+  "render",
+};
+global_variable profile_ring_id ProfileBlockRings[ProfileBlock_Count] = {
+  ProfileRing_Sim, // LoadInternalMap
+  ProfileRing_Sim, // ProcessGameInput
+  ProfileRing_Sim, // WASAPI
+  ProfileRing_Sim, // RainUpdate
+  ProfileRing_Sim, // StreamLights
+  ProfileRing_Sim, // StreamChunks
+  ProfileRing_Sim, // UpdateLightUniforms
+  ProfileRing_Render, // BaseTexturePass
+  ProfileRing_Render, // RainPass
+  ProfileRing_Render, // SwapBuffers
+  ProfileRing_Sim, // FrameWait
+  ProfileRing_Render, // RenderWait
+};
+
+struct profile_frame_record{
+  uint64 FrameCycles; // (ProfileBeginFrame -> ProfileEndFrame)
+  uint64 BlockCycles[ProfileBlock_Count];
+  uint32 BlockHits[ProfileBlock_Count];
+};
+
+struct profile_ring{
+  static const uint32 MAX_FRAMES = 512; // (Ring size: enough samples for a p99)
+  profile_frame_record Frames[MAX_FRAMES];
+  uint64 FrameIndex; // (Monotonic: current record = Frames[FrameIndex % MAX_FRAMES])
+  uint64 FrameStartCycles;
+};
+
+struct profiler{
+  profile_ring Rings[ProfileRing_Count];
+  real64 CyclesPerSecond; // (0 until the platform layer calibrates: reports fall back to cycles)
+};
+global_variable profiler GlobalProfiler;
+
+inline profile_frame_record* ProfileCurrentFrame(profile_ring_id RingID){
+  profile_ring* Ring = &GlobalProfiler.Rings[RingID];
+  return &Ring->Frames[Ring->FrameIndex % profile_ring::MAX_FRAMES];
+}
+
+struct profile_scope{
+  profile_block_id ID;
+  uint64 StartCycles;
+
+  profile_scope(profile_block_id BlockID){
+    ID = BlockID;
+    StartCycles = ReadCPUTimer();
+  }
+  ~profile_scope(){
+    uint64 Elapsed = ReadCPUTimer() - StartCycles;
+    profile_frame_record* Record = ProfileCurrentFrame(ProfileBlockRings[ID]);
+    AtomicAddU64(&Record->BlockCycles[ID], Elapsed);
+    AtomicAddI32((volatile int32*)&Record->BlockHits[ID], 1);
+  }
+};
+
+#if PROFILER
+#define TIMED_BLOCK__(Name, Line) profile_scope ProfileScope_##Line(ProfileBlock_##Name)
+#define TIMED_BLOCK_(Name, Line) TIMED_BLOCK__(Name, Line)
+#define TIMED_BLOCK(Name) TIMED_BLOCK_(Name, __LINE__)
+#else
+#define TIMED_BLOCK(Name)
+#endif
+
+// (Owning thread only)
+internal void ProfileBeginFrame(profile_ring_id RingID = ProfileRing_Sim){
+  profile_frame_record* Record = ProfileCurrentFrame(RingID);
+  memset(Record, 0, sizeof(*Record));
+  GlobalProfiler.Rings[RingID].FrameStartCycles = ReadCPUTimer();
+}
+
+internal void ProfileEndFrame(profile_ring_id RingID = ProfileRing_Sim){
+  profile_ring* Ring = &GlobalProfiler.Rings[RingID];
+  ProfileCurrentFrame(RingID)->FrameCycles = ReadCPUTimer() - Ring->FrameStartCycles;
+  Ring->FrameIndex++;
+}
+
+// AGGREGATION (on demand only)
+
+struct profile_summary{
+  uint32 FrameCount; // (Completed frames in the ring)
+  uint64 MinCycles;
+  uint64 MaxCycles;
+  uint64 P99Cycles;
+  real64 MeanCycles;
+  real64 MeanHits;
+};
+
+internal int CompareCycles(const void* A, const void* B){
+  uint64 X = *(uint64*)A;
+  uint64 Y = *(uint64*)B;
+  return (X < Y) ? -1 : (X > Y);
+}
+
+// (ID == ProfileBlock_Count summarizes the ring's whole-frame cycles. Owning thread only, or once it has stopped)
+internal profile_summary ProfileSummarize(profile_ring_id RingID, uint32 ID){
+  uint64 Samples[profile_ring::MAX_FRAMES]; // (Per call: the two rings' threads may summarize at once)
+  profile_summary Result = {};
+  profile_ring* Ring = &GlobalProfiler.Rings[RingID];
+
+  uint64 FrameCount = Ring->FrameIndex < profile_ring::MAX_FRAMES ? Ring->FrameIndex : profile_ring::MAX_FRAMES;
+  if(FrameCount == 0){ return Result; }
+  Result.FrameCount = (uint32)FrameCount;
+
+  uint64 TotalCycles = 0;
+  uint64 TotalHits = 0;
+  for(uint64 i = 0; i < FrameCount; ++i){
+    // (Oldest -> newest completed frame)
+    profile_frame_record* Record = &Ring->Frames[(Ring->FrameIndex - FrameCount + i) % profile_ring::MAX_FRAMES];
+    Samples[i] = (ID == ProfileBlock_Count) ? Record->FrameCycles : Record->BlockCycles[ID];
+    TotalCycles += Samples[i];
+    TotalHits += (ID == ProfileBlock_Count) ? 1 : Record->BlockHits[ID];
+  }
+  qsort(Samples, FrameCount, sizeof(uint64), CompareCycles);
+
+  Result.MinCycles = Samples[0];
+  Result.MaxCycles = Samples[FrameCount - 1];
+  Result.P99Cycles = Samples[((FrameCount - 1) * 99) / 100];
+  Result.MeanCycles = (real64)TotalCycles / FrameCount;
+  Result.MeanHits = (real64)TotalHits / FrameCount;
+  return Result;
+}
+
+// (Human-readable dump of one ring's blocks through PlatformOutputDebugString: from the ring's own thread)
+internal void ProfileReport(profile_ring_id RingID = ProfileRing_Sim){
+  char Buffer[256];
+  real64 Scale = GlobalProfiler.CyclesPerSecond > 0 ? (1000.0 / GlobalProfiler.CyclesPerSecond) : (1.0 / 1e6);
+  const char* Unit = GlobalProfiler.CyclesPerSecond > 0 ? "ms" : "Mcy";
+
+  sprintf(Buffer, "(%s frames)\n", ProfileRingNames[RingID]);
+  PlatformOutputDebugString(Buffer);
+  for(uint32 i = 0; i <= ProfileBlock_Count; ++i){
+    if(i < ProfileBlock_Count && ProfileBlockRings[i] != RingID){ continue; }
+    profile_summary Summary = ProfileSummarize(RingID, i);
+    if(Summary.FrameCount == 0){ return; }
+    sprintf(Buffer, "%-20s min %8.3f%s --- mean %8.3f%s --- p99 %8.3f%s --- max %8.3f%s --- hits/frame %.2f\n",
+	    (i == ProfileBlock_Count) ? "Frame" : ProfileBlockNames[i],
+	    Summary.MinCycles * Scale, Unit,
+	    Summary.MeanCycles * Scale, Unit,
+	    Summary.P99Cycles * Scale, Unit,
+	    Summary.MaxCycles * Scale, Unit,
+	    Summary.MeanHits);
+    PlatformOutputDebugString(Buffer);
+  }
+}
+
+#define PROFILER_H
+#endif
@@ -0,0 +1,539 @@
+#if !defined(RAIN_H)
+
+// (Particle storage: structure of arrays, one SIMD lane per drop)
+// (Arrays are 16-byte aligned; the kernel's vector loop runs over whole groups of RAIN_LANES)
+#define RAIN_LANES 4
+struct rain_drops{
+  real32* PosX;
+  real32* PosY;
+  real32* VelX; // (Per-step move, fixed at spawn: RainStepSpeed(Velocity) * (sin, cos)(Angle))
+  real32* VelY;
+  real32* Size; // (Radius in pixels)
+};
+
+// (Drop motion: angle fixed at 3.5 radians, random speed in [135, 195) pixels per second)
+#define RAIN_ANGLE 3.5f
+#define RAIN_MIN_SPEED 135.0f
+#define RAIN_MAX_SPEED 195.0f
+#define RAIN_DRIFT 0.374586f // (tan(RAIN_ANGLE): columns a drop drifts left per row it falls)
+
+// (Spawn lines, just off screen: y = RAIN_SPAWN_TOP for x <= RAIN_SPAWN_RIGHT, then x = RAIN_SPAWN_RIGHT)
+#define RAIN_SPAWN_TOP (InternalHeight + 10.0f)
+#define RAIN_SPAWN_RIGHT (InternalWidth + 10.0f)
+
+// (Pixels per second -> pixels per sim step: drops keep the step of the sim rate they spawned at)
+inline real32 RainStepSpeed(real32 Speed){
+  return (real32)(Speed / GlobalSimHz);
+}
+
+// (Respawn drop Index along the top / right edges)
+// (A right-edge spawn at height y stands in for a top spawn (RAIN_SPAWN_TOP - y) * RAIN_DRIFT further right,
+//  traced back along the fall. Picking uniformly along that extended top line gives the right edge
+//  RAIN_DRIFT spawns per row for the top's one per column, so the screen fills evenly; uniform along the bare
+//  edges overfed the right edge and skewed the rain right)
+internal void RainResetDrop(rain_drops* Drops, uint32 Index, random_series* Series){
+  // (When drop reaches bottom of screen)
+  real32 x = RandomBetween(Series, 0.0f, RAIN_SPAWN_RIGHT + (RAIN_SPAWN_TOP * RAIN_DRIFT));
+  Drops->PosX[Index] = x > RAIN_SPAWN_RIGHT ? RAIN_SPAWN_RIGHT : x;
+  Drops->PosY[Index] = x > RAIN_SPAWN_RIGHT ? RAIN_SPAWN_TOP - ((x - RAIN_SPAWN_RIGHT) / RAIN_DRIFT) : RAIN_SPAWN_TOP;
+
+  // Drop.Angle = 3.5f + (0.5f * ((real32)rand() / RAND_MAX));
+  real32 Velocity = RainStepSpeed(RandomBetween(Series, RAIN_MIN_SPEED, RAIN_MAX_SPEED));
+  Drops->VelX[Index] = Velocity * sinf(RAIN_ANGLE);
+  Drops->VelY[Index] = Velocity * cosf(RAIN_ANGLE);
+
+  Drops->Size[Index] = RandomBetween(Series, 1.0f, 2.0f); // TODO: can size be uniform?
+}
+
+// (First spawn of drops [0, Count): anywhere on screen, filled a whole array at a time)
+internal void RainInitDrops(rain_drops* Drops, uint32 Count, random_series* Series){
+  random_series_4x Lanes = RandomSeries4x(Series);
+  RandomFillBetween(&Lanes, Drops->PosX, Count, 0.0f, (real32)InternalWidth);
+  RandomFillBetween(&Lanes, Drops->PosY, Count, 0.0f, (real32)InternalHeight);
+  RandomFillBetween(&Lanes, Drops->VelX, Count, RAIN_MIN_SPEED, RAIN_MAX_SPEED); // (Speeds: split below)
+  RandomFillBetween(&Lanes, Drops->Size, Count, 1.0f, 2.0f);
+
+  real32 DirectionX = RainStepSpeed(sinf(RAIN_ANGLE));
+  real32 DirectionY = RainStepSpeed(cosf(RAIN_ANGLE));
+  for(uint32 i = 0; i < Count; ++i){
+    real32 Velocity = Drops->VelX[i];
+    Drops->VelX[i] = Velocity * DirectionX;
+    Drops->VelY[i] = Velocity * DirectionY;
+  }
+}
+
+// (Instance layout: position, velocity (see rain.vert))
+inline void RainWriteInstance(real32* InstanceData, rain_drops* Drops, uint32 Index){
+  InstanceData[Index * 4] = Drops->PosX[Index];
+  InstanceData[Index * 4 + 1] = Drops->PosY[Index];
+  InstanceData[Index * 4 + 2] = Drops->VelX[Index];
+  InstanceData[Index * 4 + 3] = -Drops->VelY[Index];
+}
+
+// (Step Count drops, respawn the ones that left the screen, and write their instances (if InstanceData))
+// (SSE: step + bounds test four lanes at a time, movemask -> respawn only the flagged lanes)
+internal void RainStepDrops(rain_drops* Drops, uint32 Count, real32* InstanceData, random_series* Series){
+  uint32 VectorCount = Count & ~(RAIN_LANES - 1);
+  __m128 Zero = _mm_setzero_ps();
+  __m128 SignBit = _mm_set1_ps(-0.0f);
+
+  for(uint32 i = 0; i < VectorCount; i += RAIN_LANES){
+    __m128 PosX = _mm_add_ps(_mm_load_ps(&Drops->PosX[i]), _mm_load_ps(&Drops->VelX[i]));
+    __m128 PosY = _mm_add_ps(_mm_load_ps(&Drops->PosY[i]), _mm_load_ps(&Drops->VelY[i]));
+    _mm_store_ps(&Drops->PosX[i], PosX);
+    _mm_store_ps(&Drops->PosY[i], PosY);
+
+    // (Check for ground collision)
+    int RespawnMask = _mm_movemask_ps(_mm_or_ps(_mm_cmplt_ps(PosY, Zero), _mm_cmplt_ps(PosX, Zero)));
+    if(RespawnMask){
+      for(uint32 Lane = 0; Lane < RAIN_LANES; ++Lane){
+	if(RespawnMask & (1 << Lane)){ RainResetDrop(Drops, i + Lane, Series); }
+      }
+      PosX = _mm_load_ps(&Drops->PosX[i]);
+      PosY = _mm_load_ps(&Drops->PosY[i]);
+    }
+
+    if(InstanceData){
+      // (4 lanes x (x, y, vx, -vy) -> 4 interleaved instances)
+      __m128 VelX = _mm_load_ps(&Drops->VelX[i]);
+      __m128 VelY = _mm_xor_ps(_mm_load_ps(&Drops->VelY[i]), SignBit);
+      _MM_TRANSPOSE4_PS(PosX, PosY, VelX, VelY);
+      _mm_storeu_ps(&InstanceData[i * 4], PosX);
+      _mm_storeu_ps(&InstanceData[i * 4 + 4], PosY);
+      _mm_storeu_ps(&InstanceData[i * 4 + 8], VelX);
+      _mm_storeu_ps(&InstanceData[i * 4 + 12], VelY);
+    }
+  }
+
+  // (Scalar tail)
+  for(uint32 i = VectorCount; i < Count; ++i){
+    Drops->PosX[i] += Drops->VelX[i];
+    Drops->PosY[i] += Drops->VelY[i];
+    if(Drops->PosY[i] < 0 || Drops->PosX[i] < 0){ RainResetDrop(Drops, i, Series); }
+    if(InstanceData){ RainWriteInstance(InstanceData, Drops, i); }
+  }
+}
+
+// (CPU step across the job system: fixed RAIN_JOB_CHUNK-drop jobs, a multiple of RAIN_LANES so every chunk's
+//  arrays stay 16-byte aligned)
+#define RAIN_JOB_CHUNK 8192
+struct rain_step_job{
+  rain_drops* Drops;
+  real32* InstanceData; // (0: step only)
+  uint64 FrameSeed; // (Chunk k respawns from RandomSeed(FrameSeed, k): the same drops whichever thread runs it)
+};
+
+internal void RainStepJob(void* Data, uint32 Begin, uint32 End){
+  rain_step_job* Job = (rain_step_job*)Data;
+  rain_drops Chunk;
+  Chunk.PosX = Job->Drops->PosX + Begin;
+  Chunk.PosY = Job->Drops->PosY + Begin;
+  Chunk.VelX = Job->Drops->VelX + Begin;
+  Chunk.VelY = Job->Drops->VelY + Begin;
+  Chunk.Size = Job->Drops->Size + Begin;
+  random_series Series = RandomSeed(Job->FrameSeed, Begin / RAIN_JOB_CHUNK);
+  RainStepDrops(&Chunk, End - Begin, Job->InstanceData ? Job->InstanceData + (Begin * 4) : 0, &Series);
+}
+
+// (Stateless mode: immutable per-drop spawn data, positions computed in rain_stateless.vert)
+struct rain_spawn_instance{
+  uint32 Seed;
+  real32 SpawnTime; // (Frames: <= 0, so every drop is already mid-flight at time 0)
+  real32 StepX, StepY; // (Same per-frame step as rain_drops VelX / VelY)
+};
+
+// (Frames for a drop to fall from the top spawn line below the screen: mirrored in rain_stateless.vert)
+inline real32 RainSpawnLifetime(real32 StepY){
+  return (InternalHeight + 10) / -StepY;
+}
+
+// (Transform feedback mode: full per-drop state lives on the GPU, stepped by rain_update.vert)
+// (Position + Velocity double as rain.vert's instance attributes, so the draw reads this buffer as-is)
+struct rain_feedback_drop{
+  real32 PosX, PosY;
+  real32 VelX, VelY; // (Instance convention: (step x, -step y))
+  uint32 Seed; // (Respawn RNG state)
+};
+
+enum rain_sim_mode{
+  RainSim_CPU, // (Stepped by RainStepDrops, instances streamed every frame)
+  RainSim_Stateless, // (Static spawn instances + a time uniform: no per-drop CPU work)
+  RainSim_Feedback, // (Stateful drops stepped on the GPU, ping-ponging two buffers)
+
+  RainSim_Count
+};
+
+global_variable const uint32 DEFAULT_RAIN_CAPACITY = 1000;
+// (Feedback steps the render side may replay in one frame to catch up with the sim: any further backlog is dropped)
+global_variable const uint32 RAIN_MAX_FEEDBACK_CATCHUP = 4;
+
+// (One simulated rain frame, as handed to the render side (see render_frame): rain_system::Update fills it,
+//  rain_system::Draw consumes it)
+struct rain_frame{
+  rain_sim_mode Mode;
+  uint32 InstanceCount;
+  real32* Instances; // (RainSim_CPU: InstanceCount x (x, y, vx, -vy), 16-byte aligned)
+  uint32 InstanceCapacity;
+  uint32 StatelessFrame; // (RainSim_Stateless: the time uniform)
+  uint64 FeedbackFrame; // (RainSim_Feedback: GPU steps owed since InitFeedback)
+  real32 WindX, WindY; // (Per step)
+};
+
+// (Grow Frame's instance array to hold Count drops: sim side, reused across frames)
+internal void RainFrameReserve(rain_frame* Frame, uint32 Count){
+  if(Frame->InstanceCapacity >= Count){ return; }
+  if(Frame->Instances){ PlatformFreeMemory(Frame->Instances); }
+  Frame->Instances = (real32*)PlatformAllocateMemory(sizeof(real32) * 4 * (size_t)Count);
+  Frame->InstanceCapacity = Count;
+}
+
+// (Sim-side state is touched by Update only, render-side state (GL objects, FeedbackSource / FeedbackStepped,
+//  InstanceBufferCapacity) by Draw only, so the two can run on different threads)
+struct rain_system {
+  // (CPU drops: one heap block split into lane-padded arrays (see AllocateDrops))
+  rain_drops Drops;
+  void* DropStorage;
+  uint32 Capacity;
+  uint32 ActiveCount; // (Drops [0, ActiveCount) are live)
+  random_series Entropy; // (Every spawn in every mode: seeded by InitGlobalGLRendering)
+
+  rain_sim_mode Mode;
+  uint32 StatelessCount; // (Instances in RainSpawnVBO)
+  uint32 StatelessFrame; // (Stateless clock: frames since InitStateless)
+  GLint TimeLocation;
+
+  uint32 FeedbackCount; // (Drops in each RainFeedbackVBOs buffer)
+  uint64 FeedbackFrame; // (Sim: frames simulated since InitFeedback)
+  uint64 FeedbackStepped; // (Render: GPU steps run since InitFeedback)
+  uint32 FeedbackSource; // (Render: buffer holding the current state: the update writes the other one)
+  real32 WindX, WindY; // (Push on top of each drop's own motion (gusts), pixels per second)
+  GLint WindLocation;
+
+  uint32 InstanceBufferCapacity; // (Render: drops RainInstanceVBO has storage for)
+  GLint LagLocation, DriftLocation; // (rain.vert's blend uniforms)
+
+  const real32 RainVertices[16] = {
+    // positions     // texture coords
+    -0.5f, -0.5f,   0.0f, 0.0f,
+    0.5f, -0.5f,   1.0f, 0.0f,
+    0.5f,  0.5f,   1.0f, 1.0f,
+    -0.5f,  0.5f,   0.0f, 1.0f
+  };
+
+  void InitGL(){
+    
+    real32 RainVertices[] = {
+      // positions     // texture coords
+      -0.5f, -0.5f,   0.0f, 0.0f,
+      0.5f, -0.5f,   1.0f, 0.0f,
+      0.5f,  0.5f,   1.0f, 1.0f,
+      -0.5f,  0.5f,   0.0f, 1.0f
+    };
+
+    // Generate and bind rain VAO/VBO
+    glGenVertexArrays(1, &GlobalGLRenderer.RainVAO);
+    glGenBuffers(1, &GlobalGLRenderer.RainVBO);
+    glGenBuffers(1, &GlobalGLRenderer.RainInstanceVBO);
+        
+    glBindVertexArray(GlobalGLRenderer.RainVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, GlobalGLRenderer.RainVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(RainVertices), RainVertices, GL_STATIC_DRAW);
+
+    // (Positions)
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(real32), (void*)0);
+    glEnableVertexAttribArray(0);
+
+    // (Texture coords)
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(real32), (void*)(2 * sizeof(real32)));
+    glEnableVertexAttribArray(1);
+
+    // (Instance storage is grown by Draw as frames need it: frames stream into it through BeginInstanceWrites)
+    glBindBuffer(GL_ARRAY_BUFFER, GlobalGLRenderer.RainInstanceVBO);
+
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(real32), (void*)0);  // Position
+    glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(real32), (void*)(2 * sizeof(real32))); // Velocity
+
+    glEnableVertexAttribArray(2);
+    glEnableVertexAttribArray(3);
+
+    glVertexAttribDivisor(2, 1);  // Instance rate for position
+    glVertexAttribDivisor(3, 1);  // Instance rate for velocity	  
+
+    glGenTextures(1, &GlobalGLRenderer.RainTexture);
+    glBindTexture(GL_TEXTURE_2D, GlobalGLRenderer.RainTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    const int32 TEX_SIZE = 32;
+    unsigned char texData[TEX_SIZE * TEX_SIZE];
+
+    // (Base texture)
+    /* 
+       for(int y = 0; y < TEX_SIZE; y++) {
+       for(int x = 0; x < TEX_SIZE; x++) {
+       texData[y*TEX_SIZE + x] = 255;
+       }
+       }
+    */
+    // (Ellipse texture:)
+    for(int y = 0; y < TEX_SIZE; y++) {
+      for(int x = 0; x < TEX_SIZE; x++) {
+	float dx = (x - TEX_SIZE/2.0f) / (TEX_SIZE/4.0f);
+	float dy = (y - TEX_SIZE/2.0f) / (TEX_SIZE/2.0f);
+	float dist = dx*dx + dy*dy;
+	texData[y*TEX_SIZE + x] = (dist <= 1.0f) ? 255 : 0;
+      }}
+	
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, TEX_SIZE, TEX_SIZE, 0,
+		 GL_RED, GL_UNSIGNED_BYTE, texData);
+
+    // (Stateless VAO: same quad, spawn data per instance)
+    glGenVertexArrays(1, &GlobalGLRenderer.RainStatelessVAO);
+    glGenBuffers(1, &GlobalGLRenderer.RainSpawnVBO);
+    glBindVertexArray(GlobalGLRenderer.RainStatelessVAO);
+
+    glBindBuffer(GL_ARRAY_BUFFER, GlobalGLRenderer.RainVBO);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(real32), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(real32), (void*)(2 * sizeof(real32)));
+    glEnableVertexAttribArray(1);
+
+    glBindBuffer(GL_ARRAY_BUFFER, GlobalGLRenderer.RainSpawnVBO);
+    glVertexAttribIPointer(2, 1, GL_UNSIGNED_INT, sizeof(rain_spawn_instance), (void*)offsetof(rain_spawn_instance, Seed));
+    glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(rain_spawn_instance), (void*)offsetof(rain_spawn_instance, SpawnTime));
+    glVertexAttribPointer(4, 2, GL_FLOAT, GL_FALSE, sizeof(rain_spawn_instance), (void*)offsetof(rain_spawn_instance, StepX));
+    for(GLuint Attribute = 2; Attribute <= 4; ++Attribute){
+      glEnableVertexAttribArray(Attribute);
+      glVertexAttribDivisor(Attribute, 1);
+    }
+    // (Feedback VAOs, per buffer: one feeds the update pass, one the instanced draw)
+    glGenBuffers(2, GlobalGLRenderer.RainFeedbackVBOs);
+    glGenVertexArrays(2, GlobalGLRenderer.RainFeedbackUpdateVAOs);
+    glGenVertexArrays(2, GlobalGLRenderer.RainFeedbackDrawVAOs);
+    for(int Buffer = 0; Buffer < 2; ++Buffer){
+      GLuint StateVBO = GlobalGLRenderer.RainFeedbackVBOs[Buffer];
+
+      glBindVertexArray(GlobalGLRenderer.RainFeedbackUpdateVAOs[Buffer]);
+      glBindBuffer(GL_ARRAY_BUFFER, StateVBO);
+      glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(rain_feedback_drop), (void*)offsetof(rain_feedback_drop, PosX));
+      glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(rain_feedback_drop), (void*)offsetof(rain_feedback_drop, VelX));
+      glVertexAttribIPointer(2, 1, GL_UNSIGNED_INT, sizeof(rain_feedback_drop), (void*)offsetof(rain_feedback_drop, Seed));
+      glEnableVertexAttribArray(0);
+      glEnableVertexAttribArray(1);
+      glEnableVertexAttribArray(2);
+
+      glBindVertexArray(GlobalGLRenderer.RainFeedbackDrawVAOs[Buffer]);
+      glBindBuffer(GL_ARRAY_BUFFER, GlobalGLRenderer.RainVBO);
+      glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(real32), (void*)0);
+      glEnableVertexAttribArray(0);
+      glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(real32), (void*)(2 * sizeof(real32)));
+      glEnableVertexAttribArray(1);
+      glBindBuffer(GL_ARRAY_BUFFER, StateVBO);
+      glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(rain_feedback_drop), (void*)offsetof(rain_feedback_drop, PosX));
+      glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(rain_feedback_drop), (void*)offsetof(rain_feedback_drop, VelX));
+      glEnableVertexAttribArray(2);
+      glEnableVertexAttribArray(3);
+      glVertexAttribDivisor(2, 1);
+      glVertexAttribDivisor(3, 1);
+    }
+    glBindVertexArray(0);
+
+    LagLocation = GlobalGLRenderer.RainShader->GetUniformLocation("lag");
+    DriftLocation = GlobalGLRenderer.RainShader->GetUniformLocation("drift");
+}
+
+  // (Seed Count GPU-resident drops (same first spawn as RainInitDrop) into both feedback buffers)
+  // (GL: setup only, before a render thread takes the context)
+  void InitFeedback(uint32 Count){
+    rain_feedback_drop* States = (rain_feedback_drop*)PlatformAllocateMemory(Count * sizeof(rain_feedback_drop));
+    for(uint32 i = 0; i < Count; ++i){
+      real32 Velocity = RainStepSpeed(RandomBetween(&Entropy, RAIN_MIN_SPEED, RAIN_MAX_SPEED));
+      States[i].PosX = RandomBetween(&Entropy, 0.0f, (real32)InternalWidth);
+      States[i].PosY = RandomBetween(&Entropy, 0.0f, (real32)InternalHeight);
+      States[i].VelX = Velocity * sinf(RAIN_ANGLE);
+      States[i].VelY = -Velocity * cosf(RAIN_ANGLE);
+      States[i].Seed = RandomNextU32(&Entropy);
+    }
+
+    for(int Buffer = 0; Buffer < 2; ++Buffer){
+      glBindBuffer(GL_ARRAY_BUFFER, GlobalGLRenderer.RainFeedbackVBOs[Buffer]);
+      glBufferData(GL_ARRAY_BUFFER, Count * sizeof(rain_feedback_drop), States, GL_STREAM_COPY);
+    }
+    PlatformFreeMemory(States);
+
+    FeedbackCount = Count;
+    FeedbackFrame = 0;
+    FeedbackStepped = 0;
+    FeedbackSource = 0;
+    WindLocation = GlobalGLRenderer.RainUpdateShader->GetUniformLocation("wind");
+    GlobalGLRenderer.RainUpdateShader->Use();
+    GlobalGLRenderer.RainUpdateShader->SetFloat("stepSeconds", (real32)(1.0 / GlobalSimHz));
+  }
+
+  // (One GPU simulation step: FeedbackSource -> other buffer, rasterizer off)
+  void StepFeedback(real32 StepWindX, real32 StepWindY){
+    uint32 Destination = FeedbackSource ^ 1;
+
+    GlobalGLRenderer.RainUpdateShader->Use();
+    GlobalGLRenderer.RainUpdateShader->SetVec2(WindLocation, StepWindX, StepWindY);
+    glEnable(GL_RASTERIZER_DISCARD);
+    glBindVertexArray(GlobalGLRenderer.RainFeedbackUpdateVAOs[FeedbackSource]);
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, GlobalGLRenderer.RainFeedbackVBOs[Destination]);
+    glBeginTransformFeedback(GL_POINTS);
+    glDrawArrays(GL_POINTS, 0, FeedbackCount);
+    glEndTransformFeedback();
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+    glDisable(GL_RASTERIZER_DISCARD);
+    CheckGLError("After rain feedback step");
+
+    FeedbackSource = Destination;
+  }
+
+  // (Build Count immutable spawn instances and upload them once)
+  // (GL: setup only, before a render thread takes the context)
+  void InitStateless(uint32 Count){
+    rain_spawn_instance* Instances = (rain_spawn_instance*)PlatformAllocateMemory(Count * sizeof(rain_spawn_instance));
+    for(uint32 i = 0; i < Count; ++i){
+      real32 Velocity = RainStepSpeed(RandomBetween(&Entropy, RAIN_MIN_SPEED, RAIN_MAX_SPEED));
+      Instances[i].Seed = RandomNextU32(&Entropy);
+      Instances[i].StepX = Velocity * sinf(RAIN_ANGLE);
+      Instances[i].StepY = Velocity * cosf(RAIN_ANGLE);
+      Instances[i].SpawnTime = -RainSpawnLifetime(Instances[i].StepY) * RandomUnilateral(&Entropy);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, GlobalGLRenderer.RainSpawnVBO);
+    glBufferData(GL_ARRAY_BUFFER, Count * sizeof(rain_spawn_instance), Instances, GL_STATIC_DRAW);
+    PlatformFreeMemory(Instances);
+
+    StatelessCount = Count;
+    StatelessFrame = 0;
+    TimeLocation = GlobalGLRenderer.RainStatelessShader->GetUniformLocation("time");
+  }
+
+  // (Five arrays of Stride floats each: Stride is a RAIN_LANES multiple, so with a 16-byte aligned block
+  //  (PlatformAllocateMemory) every array stays aligned for the kernel's vector loads)
+  void AllocateDrops(uint32 NewCapacity){
+    if(DropStorage){ PlatformFreeMemory(DropStorage); }
+    uint32 Stride = (NewCapacity + RAIN_LANES - 1) & ~(RAIN_LANES - 1);
+    DropStorage = PlatformAllocateMemory(5 * (size_t)Stride * sizeof(real32));
+
+    real32* Arrays = (real32*)DropStorage;
+    Drops.PosX = Arrays;
+    Drops.PosY = Arrays + Stride;
+    Drops.VelX = Arrays + (2 * Stride);
+    Drops.VelY = Arrays + (3 * Stride);
+    Drops.Size = Arrays + (4 * Stride);
+    Capacity = NewCapacity;
+  }
+
+  // TODO: Rename ('initsystem')
+  // (Re-callable: reallocates the drop arrays for NewCapacity drops, NewActiveCount of them live)
+  void InitSystem(uint32 NewCapacity, uint32 NewActiveCount){
+    AllocateDrops(NewCapacity);
+    ActiveCount = NewActiveCount < Capacity ? NewActiveCount : Capacity;
+    RainInitDrops(&Drops, ActiveCount, &Entropy);
+  }
+
+  // (Map Count instances for writing: invalidating the whole buffer lets the driver orphan the storage the
+  //  previous draw is still reading, so neither side waits and nothing is reallocated)
+  real32* BeginInstanceWrites(uint32 Count){
+    glBindBuffer(GL_ARRAY_BUFFER, GlobalGLRenderer.RainInstanceVBO);
+    if(Count == 0){ return 0; }
+    if(Count > InstanceBufferCapacity){
+      glBufferData(GL_ARRAY_BUFFER, sizeof(real32) * Count * 4, NULL, GL_STREAM_DRAW);
+      InstanceBufferCapacity = Count;
+    }
+    return (real32*)glMapBufferRange(GL_ARRAY_BUFFER, 0, sizeof(real32) * Count * 4,
+				     GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+  }
+
+  void EndInstanceWrites(real32* InstanceData){
+    if(InstanceData){ glUnmapBuffer(GL_ARRAY_BUFFER); }
+  }
+
+  // (Sim side: advance one frame and describe it in Frame (no GL))
+  void Update(rain_frame* Frame){
+    TIMED_BLOCK(RainUpdate);
+    Frame->Mode = Mode;
+    Frame->WindX = RainStepSpeed(WindX);
+    Frame->WindY = RainStepSpeed(WindY);
+    if(Mode == RainSim_Stateless){
+      // (Only the clock advances: positions come from rain_stateless.vert)
+      StatelessFrame++;
+      Frame->StatelessFrame = StatelessFrame;
+      Frame->InstanceCount = StatelessCount;
+      return;
+    }
+    if(Mode == RainSim_Feedback){
+      // (The step itself is GPU work: Draw runs it)
+      FeedbackFrame++;
+      Frame->FeedbackFrame = FeedbackFrame;
+      Frame->InstanceCount = FeedbackCount;
+      return;
+    }
+    // (Each drop's instance goes straight into the frame)
+    RainFrameReserve(Frame, ActiveCount);
+    rain_step_job StepJob = { &Drops, Frame->Instances, RandomNextU32(&Entropy) };
+    ParallelForWait(&GlobalJobSystem, ActiveCount, RAIN_JOB_CHUNK, RainStepJob, &StepJob);
+    Frame->InstanceCount = ActiveCount;
+  }
+
+  // (Render side: instanced quads over Frame's mode, after streaming / stepping whatever it brings)
+  // (Blend: see RenderFrameBlend. Redraw: Frame was drawn before, its instances / steps are already on the GPU)
+  // (No per-drop previous state is kept: a drop's last step is its own velocity, so the shaders just draw it
+  //  (1 - Blend) of a step back. Respawned drops land above / right of the screen, where stepping them back
+  //  keeps them out of sight)
+  void Draw(rain_frame* Frame, real32 Blend, bool32 Redraw){
+    real32 Lag = 1.0f - Blend;
+    if(Frame->Mode == RainSim_CPU && !Redraw){
+      real32* InstanceData = BeginInstanceWrites(Frame->InstanceCount);
+      if(InstanceData){ memcpy(InstanceData, Frame->Instances, sizeof(real32) * 4 * Frame->InstanceCount); }
+      EndInstanceWrites(InstanceData);
+    }
+    else if(Frame->Mode == RainSim_Feedback){
+      // (One GPU step per simulated frame: frames the render side skipped are replayed here, a redraw owes none)
+      if(Frame->FeedbackFrame - FeedbackStepped > RAIN_MAX_FEEDBACK_CATCHUP){
+	FeedbackStepped = Frame->FeedbackFrame - RAIN_MAX_FEEDBACK_CATCHUP;
+      }
+      for(; FeedbackStepped < Frame->FeedbackFrame; ++FeedbackStepped){
+	StepFeedback(Frame->WindX, Frame->WindY);
+      }
+    }
+
+    if(Frame->Mode == RainSim_Stateless){
+      GlobalGLRenderer.RainStatelessShader->Use();
+      GlobalGLRenderer.RainStatelessShader->SetFloat(TimeLocation, (real32)Frame->StatelessFrame - Lag);
+    }
+    else{
+      GlobalGLRenderer.RainShader->Use();
+      GlobalGLRenderer.RainShader->SetFloat(LagLocation, Lag);
+      if(Frame->Mode == RainSim_Feedback){
+	GlobalGLRenderer.RainShader->SetVec2(DriftLocation, Frame->WindX, Frame->WindY);
+      }
+      else{
+	GlobalGLRenderer.RainShader->SetVec2(DriftLocation, 0.0f, 0.0f);
+      }
+    }
+    CheckGLError("After shader use");
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, GlobalGLRenderer.RainTexture);
+    CheckGLError("After rain texture bind");
+    GLuint VAO = GlobalGLRenderer.RainVAO;
+    if(Frame->Mode == RainSim_Stateless){
+      VAO = GlobalGLRenderer.RainStatelessVAO;
+    }
+    else if(Frame->Mode == RainSim_Feedback){
+      // (Draw straight from the buffer the last step wrote)
+      VAO = GlobalGLRenderer.RainFeedbackDrawVAOs[FeedbackSource];
+    }
+    glBindVertexArray(VAO);
+    CheckGLError("After rain VAO bind");
+    glDrawArraysInstanced(GL_TRIANGLE_FAN, 0, 4, Frame->InstanceCount);
+    CheckGLError("After rain draw");
+  }
+  
+};
+global_variable rain_system GlobalRainSystem;
+
+#define RAIN_H
+#endif
@@ -5,15 +5,22 @@ layout (location = 1) in vec2 aTexCoord;    // Texture coordinates
 layout (location = 2) in vec2 aOffset;      // Instance position
 layout (location = 3) in vec2 aVelocity;    // Raindrop velocity for motion blur
 
+// (Render blending: each instance is drawn lag steps back along its own step (plus the feedback wind) towards
+//  where it was on the previous sim step (see rain_system::Draw))
+uniform float lag;
+uniform vec2 drift;
+uniform float simHz; // (aVelocity is per sim step: the streak is sized per second)
+
 out vec2 TexCoord;
 out vec2 Velocity;
 out float VerticalFade;
 
 void main() {
     // float velMagnitude = length(aVelocity);
-    float stretch = 1.0 + (length(aVelocity) * 2);
+    float stretch = 1.0 + (length(aVelocity) * simHz / 15.0); // (1/15 s of fall)
     vec2 stretchPos = aPos * vec2(1, stretch);
-    vec2 pos = stretchPos + aOffset;
+    vec2 offset = aOffset - lag * (vec2(aVelocity.x, -aVelocity.y) + drift);
+    vec2 pos = stretchPos + offset;
 
     
     // ROTATION START
@@ -22,7 +29,7 @@ void main() {
     float s = sin(angle);
     mat2 rotation = mat2(c, -s, s, c);
     vec2 rPos = rotation * stretchPos;
-    pos = rPos + aOffset;
+    pos = rPos + offset;
     // ROTATION END
     
     // Convert from pixel coordinates to OpenGL coordinates (-1 to 1)
@@ -31,7 +38,7 @@ void main() {
         (pos.y / 180.0) * 2.0 - 1.0   // (Using InternalHeight)
     );
 
-    VerticalFade = aOffset.y / 180.0; // (Using InternalHeight)
+    VerticalFade = offset.y / 180.0; // (Using InternalHeight)
     gl_Position = vec4(normalizedPos, 0.0, 1.0);
     TexCoord = aTexCoord;
     Velocity = aVelocity;
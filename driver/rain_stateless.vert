@@ -0,0 +1,64 @@
+// rain_stateless.vert
+// (Stateless rain: each instance only carries immutable spawn data, position is a function of time)
+#version 330 core
+layout (location = 0) in vec2 aPos;         // Vertex position
+layout (location = 1) in vec2 aTexCoord;    // Texture coordinates
+layout (location = 2) in uint aSeed;        // Per-drop hash seed
+layout (location = 3) in float aSpawnTime;  // Frame of the first spawn (<= 0: already falling at time 0)
+layout (location = 4) in vec2 aStep;        // Per-frame step (rain_system VelX, VelY)
+
+#define RAIN_DRIFT 0.374586 // (Mirrors rain.h: columns drifted per row fallen)
+
+uniform float time; // (Frames since the rain system started: fractional between sim steps)
+uniform float simHz; // (aStep is per sim step: the streak is sized per second)
+
+out vec2 TexCoord;
+out vec2 Velocity;
+out float VerticalFade;
+
+// (Integer hash: one respawn point per seed + cycle)
+uint Hash(uint x) {
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
+void main() {
+    // (Lifetime: frames to fall from the top spawn line (InternalHeight + 10) below the screen (see RainSpawnLifetime))
+    float lifetime = 190.0 / -aStep.y;
+    float age = time - aSpawnTime;
+    float cycle = floor(age / lifetime);
+    age -= cycle * lifetime;
+
+    // (Wrap-around respawn: same top / right edge split as RainResetDrop)
+    float u = float(Hash(aSeed ^ Hash(uint(cycle))) & 0xFFFFFFu) / 16777216.0;
+    float edge = u * (330.0 + (190.0 * RAIN_DRIFT));
+    vec2 spawn = (edge > 330.0) ? vec2(330.0, 190.0 - ((edge - 330.0) / RAIN_DRIFT)) : vec2(edge, 190.0);
+    vec2 aOffset = spawn + (aStep * age);
+    vec2 aVelocity = vec2(aStep.x, -aStep.y);
+
+    // (From here on: same as rain.vert)
+    float stretch = 1.0 + (length(aVelocity) * simHz / 15.0); // (1/15 s of fall, as rain.vert)
+    vec2 stretchPos = aPos * vec2(1, stretch);
+
+    float angle = atan(aVelocity.x, -aVelocity.y) * 1.1;
+    float c = cos(angle);
+    float s = sin(angle);
+    mat2 rotation = mat2(c, -s, s, c);
+    vec2 rPos = rotation * stretchPos;
+    vec2 pos = rPos + aOffset;
+
+    // Convert from pixel coordinates to OpenGL coordinates (-1 to 1)
+    vec2 normalizedPos = vec2(
+        (pos.x / 320.0) * 2.0 - 1.0,  // (Using InternalWidth)
+        (pos.y / 180.0) * 2.0 - 1.0   // (Using InternalHeight)
+    );
+
+    VerticalFade = aOffset.y / 180.0; // (Using InternalHeight)
+    gl_Position = vec4(normalizedPos, 0.0, 1.0);
+    TexCoord = aTexCoord;
+    Velocity = aVelocity;
+}
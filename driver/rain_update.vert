@@ -0,0 +1,50 @@
+// rain_update.vert
+// (Transform feedback step for stateful rain: one point per drop in, updated drop captured out)
+// (Same step + respawn rules as RainStepDrops / RainResetDrop in rain.h)
+#version 330 core
+layout (location = 0) in vec2 aPosition;
+layout (location = 1) in vec2 aVelocity;    // (Instance convention: (step x, -step y))
+layout (location = 2) in uint aSeed;
+
+#define RAIN_DRIFT 0.374586 // (Mirrors rain.h: columns drifted per row fallen)
+
+uniform vec2 wind; // (Per-step push on top of each drop's own step (gusts))
+uniform float stepSeconds; // (1 / GlobalSimHz: respawn speeds are per second, steps per sim step)
+
+out vec2 outPosition;
+out vec2 outVelocity;
+flat out uint outSeed;
+
+uint Hash(uint x) {
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
+// (Next uniform float in [0, 1) from the drop's RNG state)
+float NextRandom(inout uint state) {
+    state = Hash(state);
+    return float(state & 0xFFFFFFu) / 16777216.0;
+}
+
+void main() {
+    vec2 position = aPosition + vec2(aVelocity.x, -aVelocity.y) + wind;
+    vec2 velocity = aVelocity;
+    uint seed = aSeed;
+
+    // (Check for ground collision: respawn along the top / right edges)
+    if(position.y < 0.0 || position.x < 0.0) {
+        float edge = NextRandom(seed) * (330.0 + (190.0 * RAIN_DRIFT));
+        position = (edge > 330.0) ? vec2(330.0, 190.0 - ((edge - 330.0) / RAIN_DRIFT)) : vec2(edge, 190.0);
+
+        float speed = (135.0 + (60.0 * NextRandom(seed))) * stepSeconds;
+        velocity = speed * vec2(sin(3.5), -cos(3.5));
+    }
+
+    outPosition = position;
+    outVelocity = velocity;
+    outSeed = seed;
+}
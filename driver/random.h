@@ -0,0 +1,87 @@
+#if !defined(RANDOM_H)
+
+// (Seedable particle RNG: replaces the CRT rand() (shared hidden state, RAND_MAX can be 32767, weak low bits))
+// (random_series: PCG32, one value at a time. random_series_4x: four xorshift32 lanes in one SSE register,
+//  seeded from a random_series, for filling whole arrays of uniform floats)
+
+struct random_series{
+  uint64 State;
+  uint64 Increment; // (Stream selector: always odd)
+};
+
+internal uint32 RandomNextU32(random_series* Series){
+  uint64 OldState = Series->State;
+  Series->State = (OldState * 6364136223846793005ull) + Series->Increment;
+  uint32 XorShifted = (uint32)(((OldState >> 18u) ^ OldState) >> 27u);
+  uint32 Rotation = (uint32)(OldState >> 59u);
+  return (XorShifted >> Rotation) | (XorShifted << ((32 - Rotation) & 31));
+}
+
+// (Same Seed + Stream -> same sequence, on every platform)
+internal random_series RandomSeed(uint64 Seed, uint64 Stream = 1){
+  random_series Result;
+  Result.State = 0;
+  Result.Increment = (Stream << 1u) | 1u;
+  RandomNextU32(&Result);
+  Result.State += Seed;
+  RandomNextU32(&Result);
+  return Result;
+}
+
+// (Uniform in [0, 1): top 24 bits, exactly representable as a real32)
+inline real32 RandomUnilateral(random_series* Series){
+  return (real32)(RandomNextU32(Series) >> 8) * (1.0f / 16777216.0f);
+}
+
+inline real32 RandomBetween(random_series* Series, real32 Min, real32 Max){
+  return Min + ((Max - Min) * RandomUnilateral(Series));
+}
+
+// (Integer in [0, Range): multiply-shift, so the high bits pick the result instead of the weak low ones)
+inline uint32 RandomChoice(random_series* Series, uint32 Range){
+  return (uint32)(((uint64)RandomNextU32(Series) * Range) >> 32);
+}
+
+// BATCH (SSE)
+
+struct random_series_4x{
+  __m128i State; // (Four independent xorshift32 lanes: never zero)
+};
+
+internal random_series_4x RandomSeries4x(random_series* Parent){
+  uint32 Lanes[4];
+  for(int i = 0; i < 4; ++i){
+    do{ Lanes[i] = RandomNextU32(Parent); } while(Lanes[i] == 0);
+  }
+  random_series_4x Result;
+  Result.State = _mm_setr_epi32((int)Lanes[0], (int)Lanes[1], (int)Lanes[2], (int)Lanes[3]);
+  return Result;
+}
+
+// (Four uniforms in [0, 1) at once)
+inline __m128 RandomUnilateral4x(random_series_4x* Series){
+  __m128i X = Series->State;
+  X = _mm_xor_si128(X, _mm_slli_epi32(X, 13));
+  X = _mm_xor_si128(X, _mm_srli_epi32(X, 17));
+  X = _mm_xor_si128(X, _mm_slli_epi32(X, 5));
+  Series->State = X;
+  return _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(X, 8)), _mm_set1_ps(1.0f / 16777216.0f));
+}
+
+// (Dest[0, Count) = uniform floats in [Min, Max): four per step, scalar tail from the same lanes)
+internal void RandomFillBetween(random_series_4x* Series, real32* Dest, uint32 Count, real32 Min, real32 Max){
+  __m128 Base = _mm_set1_ps(Min);
+  __m128 Scale = _mm_set1_ps(Max - Min);
+  uint32 i = 0;
+  for(; i + 4 <= Count; i += 4){
+    _mm_storeu_ps(&Dest[i], _mm_add_ps(Base, _mm_mul_ps(Scale, RandomUnilateral4x(Series))));
+  }
+  if(i < Count){
+    real32 Tail[4];
+    _mm_storeu_ps(Tail, _mm_add_ps(Base, _mm_mul_ps(Scale, RandomUnilateral4x(Series))));
+    for(uint32 Lane = 0; i < Count; ++i, ++Lane){ Dest[i] = Tail[Lane]; }
+  }
+}
+
+#define RANDOM_H
+#endif
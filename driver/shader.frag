@@ -6,28 +6,115 @@ out vec4 FragColor;
 
 in vec2 TexCoord;
 in vec2 FragPos;
+flat in int LightIndex; // (Light-volume pass: the light this quad bounds)
 
 uniform sampler2D gameTexture;
 uniform sampler2D angleTexture;
-
+uniform sampler2D spriteTexture;
+uniform usamplerBuffer lightTiles; // (Per-tile light lists, layout in lighting.h (CullLightTiles))
+
+uniform float screenWidth;
+uniform float screenHeight;
+
+// (Camera + player sprite, set per frame by BindBaseTextures (game.h))
+// (CPU composite mode: mapXOffset = 0 over the composed screen texture, spriteSheetOrigin.x < 0 (no overlay))
+// (mapXOffset / spritePosition.x are blended between sim steps: fractional, so they scroll below a texel)
+uniform float mapXOffset;
+// (Lights are placed for the sim step's camera: lightShiftX moves them with the blended one (0 in CPU composite
+//  mode). The tile lists are culled wide enough to cover it (lighting_system::CullMarginX))
+uniform float lightShiftX;
+// (GPU scroll mode: the map textures are a ring of resident chunks (world.h), so map columns are clamped to
+//  the world's mapWidth, then wrapped into the ring. CPU composite mode: mapWidth = screen width)
+uniform int mapWidth;
+uniform vec2 spritePosition; // (Screen column, bottom row)
+uniform ivec2 spriteSheetOrigin; // (Current frame's top-left texel in the sheet)
+uniform int spriteReversed;
+
+// (Mirrors SpriteWidth / SpriteHeight in game.h)
+#define SPRITE_WIDTH 15
+#define SPRITE_HEIGHT 20
+
+// (std140: 32 bytes per light, mirrored by light_block_entry in lighting.h)
 struct Light{
-  vec2 position;
   vec3 color;
   float intensity;
+  vec2 position;
   float radius;
 };
 
-#define MAX_LIGHTS 8
-uniform Light lights[MAX_LIGHTS];
-uniform int numActiveLights;
-uniform float ambientStrength;
+#define MAX_LIGHTS 256
+#define LIGHT_TILE_SIZE 16
+// (Counts first: the lights in use + the counts are one contiguous prefix, uploaded in one call. std140 starts
+//  the array at offset 16)
+layout (std140) uniform LightBlock{
+  int numActiveLights;
+  float ambientStrength;
+  Light lights[MAX_LIGHTS];
+};
+
+// (Which part of the lighting this draw does, mirrors light_pass in lighting.h: tiled = every light in one pass,
+//  unlit base + additive light volumes = the same result one light's screen rect at a time)
+#define LIGHT_PASS_TILED 0
+#define LIGHT_PASS_UNLIT 1
+#define LIGHT_PASS_VOLUME 2
+uniform int lightPass;
+
+// (How the angle texture holds normals, mirrors normal_decode in media.h)
+#define NORMAL_DECODE_LOAD 0
+#define NORMAL_DECODE_TRIG 1
+uniform int normalDecode;
+
+// (Light i's diffuse contribution at this fragment: zero beyond its radius)
+vec3 lightContribution(int i, vec3 baseColor, vec2 surfaceNormal){
+  // Calculate light direction and distance
+  vec2 lightDir = (lights[i].position + vec2(lightShiftX, 0.0)) - FragPos;
+  float distance = length(lightDir);
+
+  // Skip if fragment is outside light radius
+  if(distance > lights[i].radius) { return vec3(0.0); }
+
+  // Normalize light direction
+  lightDir = normalize(lightDir);
+
+  // Calculate diffuse factor based on angle
+  float diff = max(dot(surfaceNormal, lightDir), 0.0);
+
+  // Calculate attenuation based on distance
+  float attenuation = 1.0 - smoothstep(1.0, lights[i].radius, distance);
+
+  return baseColor * lights[i].color * diff * lights[i].intensity * attenuation;
+}
+
+// (Sprite sheet texel covering this screen position: same placement as BlitPlayerSprite)
+vec4 spriteTexel(ivec2 screenTexel, float screenX){
+  if(spriteSheetOrigin.x < 0){ return vec4(0.0); }
+  int row = (int(spritePosition.y) + SPRITE_HEIGHT - 1) - screenTexel.y;
+  int spriteX = int(floor(screenX - spritePosition.x));
+  int col = (spriteReversed != 0) ? SPRITE_WIDTH - spriteX : spriteX;
+  if(row < 0 || row >= SPRITE_HEIGHT || col < 0 || col >= SPRITE_WIDTH){ return vec4(0.0); }
+  return texelFetch(spriteTexture, spriteSheetOrigin + ivec2(col, row), 0);
+}
 
 void main(){
   // Get base color and angle from textures
-  vec4 baseColor = texture(gameTexture, TexCoord);
-  vec4 angleData = texture(angleTexture, TexCoord);
-
-  if(angleData.a == 0u || angleData.a == 253u || angleData.a == 254u){ FragColor = baseColor; return; }  
+  ivec2 screenSize = ivec2(int(screenWidth), int(screenHeight));
+  vec2 screenPos = TexCoord * vec2(screenSize);
+  ivec2 screenTexel = clamp(ivec2(screenPos), ivec2(0), screenSize - 1);
+  int mapX = clamp(int(floor(screenPos.x + mapXOffset)), 0, mapWidth - 1) % textureSize(gameTexture, 0).x;
+  ivec2 mapTexel = ivec2(mapX, screenTexel.y);
+  vec4 baseColor = texelFetch(gameTexture, mapTexel, 0);
+  vec4 angleData = texelFetch(angleTexture, mapTexel, 0);
+
+  // (Player sprite over the background, except behind foreground (normal map alpha 253))
+  vec4 spriteColor = spriteTexel(screenTexel, screenPos.x);
+  if(spriteColor.a != 0.0 && int(angleData.a * 255.0 + 0.5) != 253){ baseColor = spriteColor; }
+
+  if(angleData.a == 0u || angleData.a == 253u || angleData.a == 254u){
+    if(lightPass == LIGHT_PASS_VOLUME){ discard; } // (Unlit: the base pass already wrote it)
+    FragColor = baseColor;
+    return;
+  }
+  if(lightPass == LIGHT_PASS_UNLIT){ FragColor = baseColor; return; }
   // FragColor = angleData;
   // return;
   
@@ -52,36 +139,36 @@ void main(){
         return;
 	}*/
 
-  float surfaceAngleRaw = (angleData.r + angleData.g) * 255.0;
-
-  // Convert stored angle to direction vector
-  float angleRadians = radians(surfaceAngleRaw);
-  vec2 surfaceNormal = vec2(cos(angleRadians), sin(angleRadians));
+  // (Surface normal, decoded from the angle encoding at load (DecodeNormalTexel in media.h): unbias only.
+  //  NORMAL_DECODE_TRIG scenes keep the raw R + G degrees, decoded here per pixel)
+  vec2 surfaceNormal;
+  if(normalDecode == NORMAL_DECODE_TRIG){
+    float angleRadians = radians((angleData.r + angleData.g) * 255.0);
+    surfaceNormal = vec2(cos(angleRadians), sin(angleRadians));
+  }
+  else{
+    surfaceNormal = (angleData.rg * 2.0) - 1.0;
+  }
 
   // Start with ambient light
   // vec3 finalColor = baseColor.rgb * ambientStrength;
   vec3 finalColor = baseColor.rgb;
 
-  // Process each active light
-  for(int i = 0; i < numActiveLights; ++i){
-    // Calculate light direction and distance
-    vec2 lightDir = lights[i].position - FragPos;
-    float distance = length(lightDir);
-
-    // Skip if fragment is outside light radius
-    if(distance > lights[i].radius) { continue; }
-	    
-    // Normalize light direction
-    lightDir = normalize(lightDir);
-
-    // Calculate diffuse factor based on angle
-    float diff = max(dot(surfaceNormal, lightDir), 0.0);
-
-    // Calculate attenuation based on distance
-    float attenuation = 1.0 - smoothstep(1.0, lights[i].radius, distance);	    
+  // (Light volume: this light only, added over the unlit base by the blend (clamped to 1 on write, as below))
+  if(lightPass == LIGHT_PASS_VOLUME){
+    FragColor = vec4(lightContribution(LightIndex, baseColor.rgb, surfaceNormal), 0.0);
+    return;
+  }
 
+  // (Process only the lights binned into this fragment's tile)
+  int tilesX = (screenSize.x + LIGHT_TILE_SIZE - 1) / LIGHT_TILE_SIZE;
+  ivec2 tile = clamp(ivec2(FragPos) / LIGHT_TILE_SIZE, ivec2(0), (screenSize - 1) / LIGHT_TILE_SIZE);
+  int tileIndex = (tile.y * tilesX) + tile.x;
+  int firstEntry = int(texelFetch(lightTiles, 2 * tileIndex).r);
+  int tileLights = int(texelFetch(lightTiles, (2 * tileIndex) + 1).r);
+  for(int entry = firstEntry; entry < firstEntry + tileLights; ++entry){
     // (Add to this light's contribution)
-    finalColor += baseColor.rgb * lights[i].color * diff * lights[i].intensity * attenuation;
+    finalColor += lightContribution(int(texelFetch(lightTiles, entry).r), baseColor.rgb, surfaceNormal);
   }
 
   // Ensure that we don't exceed max brightness
@@ -1,59 +1,41 @@
 #if !defined(SHADER_H)
 
-struct ProcessedFile{
-  void* Contents;
-  uint32 ContentsSize; 
+// (Active uniform, reflected once at link time)
+struct shader_uniform{
+  char Name[64];
+  GLint Location;
 };
 
-internal ProcessedFile ReadEntireFile(char* Filename){
-  ProcessedFile Result = {};
-  HANDLE FileHandle = CreateFileA(Filename, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, 0, 0);
-  if(FileHandle != INVALID_HANDLE_VALUE){
-    LARGE_INTEGER FileSize;
-    if(GetFileSizeEx(FileHandle, &FileSize)){
-      uint32 FileSize32 = (uint32)FileSize.QuadPart;
-      Result.Contents = VirtualAlloc(0, FileSize32, MEM_RESERVE|MEM_COMMIT, PAGE_READWRITE);
-      if(Result.Contents){
-	DWORD BytesRead;
-	if(ReadFile(FileHandle, Result.Contents, FileSize32, &BytesRead, 0) && (FileSize32 == BytesRead)){
-	  Result.ContentsSize = FileSize32;
-	}
-	else{
-	  if(Result.Contents){
-	    VirtualFree(Result.Contents, 0, MEM_RELEASE);
-	    Result.Contents = 0;
-	  }
-	}
-      }
-    }
-    CloseHandle(FileHandle);
-  }
-  return Result;
-}
-
-  
 struct Shader{
   uint32 ID;
 
-  Shader(char* VertexPath, char* FragmentPath){
-    ProcessedFile VertexShaderFile = ReadEntireFile(VertexPath);
-    ProcessedFile FragmentShaderFile = ReadEntireFile(FragmentPath);
-    if(!VertexShaderFile.Contents || !FragmentShaderFile.Contents) {
-      OutputDebugStringA("SHADER ERROR: File Read Failed\n");
+  // (Uniform location cache: filled by ReflectUniforms(), never queried from the driver afterwards)
+  static const int32 MAX_UNIFORMS = 128;
+  shader_uniform Uniforms[MAX_UNIFORMS];
+  int32 UniformCount;
+
+  // (FragmentPath = 0: vertex-only program, e.g. a transform feedback pass capturing FeedbackVaryings)
+  Shader(char* VertexPath, char* FragmentPath, const char** FeedbackVaryings = 0, int32 FeedbackVaryingCount = 0){
+    UniformCount = 0;
+    ProcessedFile VertexShaderFile = PlatformReadEntireFile(VertexPath);
+    ProcessedFile FragmentShaderFile = {};
+    if(FragmentPath){ FragmentShaderFile = PlatformReadEntireFile(FragmentPath); }
+    if(!VertexShaderFile.Contents || (FragmentPath && !FragmentShaderFile.Contents)) {
+      PlatformOutputDebugString("SHADER ERROR: File Read Failed\n");
       return;
     }
     // (Initialize code to empty memory)
-    char* VertexCode = (char*)VirtualAlloc(0, VertexShaderFile.ContentsSize + 1,
-                                             MEM_RESERVE|MEM_COMMIT, PAGE_READWRITE);
-    char* FragmentCode = (char*)VirtualAlloc(0, FragmentShaderFile.ContentsSize + 1,
-					     MEM_RESERVE|MEM_COMMIT, PAGE_READWRITE);
+    char* VertexCode = (char*)PlatformAllocateMemory(VertexShaderFile.ContentsSize + 1);
+    char* FragmentCode = FragmentPath ? (char*)PlatformAllocateMemory(FragmentShaderFile.ContentsSize + 1) : 0;
 
-    if(VertexCode && FragmentCode){
+    if(VertexCode && (FragmentCode || !FragmentPath)){
       // (Copy in memory and set terminating chars)
-      CopyMemory(VertexCode, VertexShaderFile.Contents, VertexShaderFile.ContentsSize);
-      CopyMemory(FragmentCode, FragmentShaderFile.Contents, FragmentShaderFile.ContentsSize);
+      memcpy(VertexCode, VertexShaderFile.Contents, VertexShaderFile.ContentsSize);
       VertexCode[VertexShaderFile.ContentsSize] = '\0';
-      FragmentCode[FragmentShaderFile.ContentsSize] = '\0';
+      if(FragmentCode){
+	memcpy(FragmentCode, FragmentShaderFile.Contents, FragmentShaderFile.ContentsSize);
+	FragmentCode[FragmentShaderFile.ContentsSize] = '\0';
+      }
 
       // (Debugging vars)
       int32 Success;
@@ -68,69 +50,151 @@ struct Shader{
       glGetShaderiv(Vertex, GL_COMPILE_STATUS, &Success);
       if(!Success) {
 	glGetShaderInfoLog(Vertex, 1024, NULL, InfoLog);
-	OutputDebugStringA("SHADER ERROR: Vertex Shader Compilation\n");
-	OutputDebugStringA(InfoLog);
+	PlatformOutputDebugString("SHADER ERROR: Vertex Shader Compilation\n");
+	PlatformOutputDebugString(InfoLog);
       }
       
       // (Fragment shader compilation)
-      uint32 Fragment = glCreateShader(GL_FRAGMENT_SHADER);
-      glShaderSource(Fragment, 1, &FragmentCode, NULL);
-      glCompileShader(Fragment);
-
-      glGetShaderiv(Fragment, GL_COMPILE_STATUS, &Success);
-      if(!Success) {
-	glGetShaderInfoLog(Fragment, 1024, NULL, InfoLog);
-	OutputDebugStringA("SHADER ERROR: Fragment Shader Compilation\n");
-	OutputDebugStringA(InfoLog);
+      uint32 Fragment = 0;
+      if(FragmentCode){
+	Fragment = glCreateShader(GL_FRAGMENT_SHADER);
+	glShaderSource(Fragment, 1, &FragmentCode, NULL);
+	glCompileShader(Fragment);
+
+	glGetShaderiv(Fragment, GL_COMPILE_STATUS, &Success);
+	if(!Success) {
+	  glGetShaderInfoLog(Fragment, 1024, NULL, InfoLog);
+	  PlatformOutputDebugString("SHADER ERROR: Fragment Shader Compilation\n");
+	  PlatformOutputDebugString(InfoLog);
+	}
       }
 
       ID = glCreateProgram();
       glAttachShader(ID, Vertex);
-      glAttachShader(ID, Fragment);
+      if(Fragment){ glAttachShader(ID, Fragment); }
+      // (Captured outputs must be named before linking)
+      if(FeedbackVaryingCount > 0){
+	glTransformFeedbackVaryings(ID, FeedbackVaryingCount, FeedbackVaryings, GL_INTERLEAVED_ATTRIBS);
+      }
       glLinkProgram(ID);
 
       glGetProgramiv(ID, GL_LINK_STATUS, &Success);
       if(!Success) {
 	glGetProgramInfoLog(ID, 1024, NULL, InfoLog);
-	OutputDebugStringA("SHADER ERROR: Vertex + Shader Linking\n");
-	OutputDebugStringA(InfoLog);
+	PlatformOutputDebugString("SHADER ERROR: Vertex + Shader Linking\n");
+	PlatformOutputDebugString(InfoLog);
       }
 
       glDeleteShader(Vertex);
-      glDeleteShader(Fragment);
+      if(Fragment){ glDeleteShader(Fragment); }
+
+      ReflectUniforms();
       
     }
     // (Free memory)
-    if(VertexCode){VirtualFree(VertexCode, 0, MEM_RELEASE);}
-    if(FragmentCode){VirtualFree(FragmentCode, 0, MEM_RELEASE);}
-    if(VertexShaderFile.Contents){VirtualFree(VertexShaderFile.Contents, 0, MEM_RELEASE);}
-    if(FragmentShaderFile.Contents){VirtualFree(FragmentShaderFile.Contents, 0, MEM_RELEASE);}
+    if(VertexCode){PlatformFreeMemory(VertexCode);}
+    if(FragmentCode){PlatformFreeMemory(FragmentCode);}
+    if(VertexShaderFile.Contents){PlatformFreeMemory(VertexShaderFile.Contents);}
+    if(FragmentShaderFile.Contents){PlatformFreeMemory(FragmentShaderFile.Contents);}
     
   }
 
+  // (Walk every active uniform once and cache its location)
+  // (Arrays report only their first element ("name[0]"), so each element gets its own entry)
+  // (Uniform block members are listed too but have no location: skipped, they are set through the block's buffer)
+  void ReflectUniforms(){
+    UniformCount = 0;
+    GLint ActiveUniforms = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &ActiveUniforms);
+
+    for(GLint i = 0; i < ActiveUniforms; ++i){
+      char Name[64];
+      GLsizei NameLength = 0;
+      GLint Size = 0;
+      GLenum Type;
+      glGetActiveUniform(ID, i, sizeof(Name), &NameLength, &Size, &Type, Name);
+      if(NameLength <= 0){ continue; }
+      GLuint Index = (GLuint)i;
+      GLint BlockIndex = -1;
+      glGetActiveUniformsiv(ID, 1, &Index, GL_UNIFORM_BLOCK_INDEX, &BlockIndex);
+      if(BlockIndex != -1){ continue; }
+
+      char* ArraySuffix = (Size > 1) ? strstr(Name, "[0]") : 0;
+      if(ArraySuffix){ *ArraySuffix = '\0'; }
+      for(GLint Element = 0; Element < Size; ++Element){
+	if(UniformCount >= MAX_UNIFORMS){
+	  PlatformOutputDebugString("SHADER ERROR: Uniform cache full\n");
+	  return;
+	}
+	shader_uniform* Uniform = &Uniforms[UniformCount++];
+	if(ArraySuffix){ snprintf(Uniform->Name, sizeof(Uniform->Name), "%s[%d]", Name, Element); }
+	else{ snprintf(Uniform->Name, sizeof(Uniform->Name), "%s", Name); }
+	Uniform->Location = glGetUniformLocation(ID, Uniform->Name);
+      }
+    }
+  }
+
+  // (Setup-time lookup into the cache: -1 if the uniform isn't active (glUniform* ignores -1))
+  GLint GetUniformLocation(const char* Name){
+    for(int32 i = 0; i < UniformCount; ++i){
+      if(strcmp(Uniforms[i].Name, Name) == 0){ return Uniforms[i].Location; }
+    }
+    return -1;
+  }
+
+  // (Point a named uniform block at a buffer binding index)
+  void BindUniformBlock(const char* Name, GLuint Binding){
+    GLuint BlockIndex = glGetUniformBlockIndex(ID, Name);
+    if(BlockIndex != GL_INVALID_INDEX){
+      glUniformBlockBinding(ID, BlockIndex, Binding);
+    }
+  }
+
   // Their suggested helpers:
   void Use() { 
     glUseProgram(ID); 
   }
-  
+
+  // (Per-frame path: precomputed handles from GetUniformLocation)
+  void SetInt(GLint Location, int Value) {
+    glUniform1i(Location, Value);
+  }
+
+  void SetFloat(GLint Location, float Value) {
+    glUniform1f(Location, Value);
+  }
+
+  void SetVec2(GLint Location, float x, float y) {
+    glUniform2f(Location, x, y);
+  }
+
+  void SetIVec2(GLint Location, int x, int y) {
+    glUniform2i(Location, x, y);
+  }
+
+  void SetVec3(GLint Location, float x, float y, float z) {
+    glUniform3f(Location, x, y, z);
+  }
+
+  // (By-name versions: setup only, resolved through the cache)
   void SetBool(const char* Name, bool Value) {
-    glUniform1i(glGetUniformLocation(ID, Name), (int)Value);
+    SetInt(GetUniformLocation(Name), (int)Value);
   }
 
   void SetInt(const char* Name, int Value) {
-    glUniform1i(glGetUniformLocation(ID, Name), Value);
+    SetInt(GetUniformLocation(Name), Value);
   }
 
   void SetFloat(const char* Name, float Value) {
-    glUniform1f(glGetUniformLocation(ID, Name), Value);
+    SetFloat(GetUniformLocation(Name), Value);
   }
 
   void SetVec2(const char* Name, float x, float y) {
-    glUniform2f(glGetUniformLocation(ID, Name), x, y);
+    SetVec2(GetUniformLocation(Name), x, y);
   }
 
   void SetVec3(const char* Name, float x, float y, float z) {
-    glUniform3f(glGetUniformLocation(ID, Name), x, y, z);
+    SetVec3(GetUniformLocation(Name), x, y, z);
   }
 
   
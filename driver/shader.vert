@@ -8,15 +8,49 @@ layout (location = 1) in vec2 aTexCoord;
 uniform float screenWidth;
 uniform float screenHeight;
 
+// (Mirrors shader.frag: which part of the lighting this draw does)
+#define LIGHT_PASS_TILED 0
+#define LIGHT_PASS_UNLIT 1
+#define LIGHT_PASS_VOLUME 2
+uniform int lightPass;
+uniform float lightShiftX; // (As shader.frag: the volume follows its light to the blended camera)
+
+// (Same block as shader.frag: light volumes are sized from it)
+struct Light{
+  vec3 color;
+  float intensity;
+  vec2 position;
+  float radius;
+};
+
+#define MAX_LIGHTS 256
+layout (std140) uniform LightBlock{
+  int numActiveLights;
+  float ambientStrength;
+  Light lights[MAX_LIGHTS];
+};
+
 out vec2 TexCoord;
 out vec2 FragPos;
+flat out int LightIndex;
 
 void main() {
-  gl_Position = vec4(aPos, 1.0); 
-  TexCoord = aTexCoord;
+  // (Screen rect this quad covers: the whole screen, or in a light-volume pass (instanced, one per light) the
+  //  bounds of light gl_InstanceID's radius)
+  vec2 screenSize = vec2(screenWidth, screenHeight);
+  vec2 rectMin = vec2(0.0);
+  vec2 rectMax = screenSize;
+  LightIndex = -1;
+  if(lightPass == LIGHT_PASS_VOLUME){
+    LightIndex = gl_InstanceID;
+    vec2 lightPosition = lights[gl_InstanceID].position + vec2(lightShiftX, 0.0);
+    rectMin = clamp(lightPosition - lights[gl_InstanceID].radius, vec2(0.0), screenSize);
+    rectMax = clamp(lightPosition + lights[gl_InstanceID].radius, vec2(0.0), screenSize);
+  }
+
   // (Fragment position in screen space for lighting)
-  FragPos = vec2((aPos.x + 1.0) * screenWidth / 2.0,
-		 (aPos.y + 1.0) * screenHeight / 2.0);
+  FragPos = mix(rectMin, rectMax, aTexCoord);
+  TexCoord = FragPos / screenSize;
+  gl_Position = vec4((TexCoord * 2.0) - 1.0, aPos.z, 1.0);
 }
 
-
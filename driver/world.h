@@ -0,0 +1,262 @@
+#if !defined(WORLD_H)
+
+// (Chunked world storage: the map is cut into WORLD_CHUNK_WIDTH-column chunks and only those around the camera
+//  are resident, in a fixed ring of WORLD_RESIDENT_CHUNKS slots (chunk c always lives in slot
+//  c % WORLD_RESIDENT_CHUNKS), so memory stays the same however wide the world is)
+// (A background I/O thread reads chunks in ahead of the camera, in the walking direction; the sim only waits
+//  on one if the view outruns it)
+// (Chunk layout: WORLD_CHUNK_WIDTH x InternalHeight uint32, row-major, rows in GL order, as game_map; columns
+//  past the world's right edge are zero)
+
+#define WORLD_CHUNK_WIDTH 128
+// (1024 ring columns: a 320-column view spans up to 4 chunks, plus WORLD_PREFETCH_CHUNKS ahead and 1 behind)
+#define WORLD_RESIDENT_CHUNKS 8
+#define WORLD_PREFETCH_CHUNKS 2
+// (Newly resident chunks one render frame carries to the GPU ring: one is due every WORLD_CHUNK_WIDTH columns
+//  walked, the rest of a scene's first set goes up at load (UploadResidentSceneTextures))
+#define WORLD_MAX_CHUNK_UPLOADS 2
+global_variable const uint32 WorldChunkTexels = WORLD_CHUNK_WIDTH * InternalHeight;
+
+inline int32 WorldChunkCount(int32 Width){
+  return (Width + WORLD_CHUNK_WIDTH - 1) / WORLD_CHUNK_WIDTH;
+}
+
+enum world_chunk_state{
+  WorldChunk_Empty,
+  WorldChunk_Requested, // (Sim -> I/O thread: Chunk is to be read in)
+  WorldChunk_Loading, // (Claimed by whoever reads it: the I/O thread, or the sim when the view can't wait)
+  WorldChunk_Ready,
+};
+
+struct world_chunk_slot{
+  volatile int32 State;
+  int32 Chunk; // (Sim-written before the slot is requested: -1 while empty)
+  bool32 Uploaded; // (Sim-owned: handed to a render frame since it became ready)
+  uint32* Pixels;
+  uint32* Angles;
+};
+
+struct world_streamer{
+  world_chunk_slot Slots[WORLD_RESIDENT_CHUNKS];
+  game_map* Map; // (Chunk source: fixed while the I/O thread runs)
+  void* IOThread; // (0: not started)
+  void* IOSemaphore; // (Signaled when requests are queued)
+  volatile int32 Quit; // (StopWorldStreamer: the I/O thread exits on its next wake)
+
+  // (Sim-owned: chunks [First, Last] were wanted for StreamedXOffset, [ViewFirst, ViewLast] are under the view)
+  int32 StreamedXOffset;
+  int32 Direction; // (Last walking direction: +1 right, -1 left)
+  int32 First, Last;
+  int32 ViewFirst, ViewLast;
+
+  // (Chunks read in, and of those the ones the sim had to wait for: every one of those is a hitch)
+  volatile uint64 ChunksLoaded;
+  uint64 Stalls;
+};
+global_variable world_streamer GlobalWorldStreamer;
+
+// (Chunk Chunk of GameMap into Pixels / Angles: a read from the pack file, or a copy out of the whole map in
+//  memory (PNG scenes). False if the read failed: the chunk is then left blank)
+internal bool32 ReadWorldChunk(game_map* GameMap, int32 Chunk, uint32* Pixels, uint32* Angles){
+  uint32 ChunkBytes = WorldChunkTexels * sizeof(uint32);
+  if(GameMap->PackFile){
+    uint64 ChunkOffset = (uint64)Chunk * ChunkBytes;
+    if(PlatformReadFileAt(GameMap->PackFile, GameMap->PackPixelsOffset + ChunkOffset, Pixels, ChunkBytes) &&
+       PlatformReadFileAt(GameMap->PackFile, GameMap->PackAnglesOffset + ChunkOffset, Angles, ChunkBytes)){
+      return true;
+    }
+    memset(Pixels, 0, ChunkBytes);
+    memset(Angles, 0, ChunkBytes);
+    return false;
+  }
+
+  int32 X0 = Chunk * WORLD_CHUNK_WIDTH;
+  int32 Columns = GameMap->Width - X0 < WORLD_CHUNK_WIDTH ? GameMap->Width - X0 : WORLD_CHUNK_WIDTH;
+  for(int32 Row = 0; Row < (int32)InternalHeight; ++Row){
+    uint32* PixelRow = &Pixels[Row * WORLD_CHUNK_WIDTH];
+    uint32* AngleRow = &Angles[Row * WORLD_CHUNK_WIDTH];
+    memcpy(PixelRow, &GameMap->Pixels[(Row * GameMap->Width) + X0], Columns * sizeof(uint32));
+    memcpy(AngleRow, &GameMap->Angles[(Row * GameMap->Width) + X0], Columns * sizeof(uint32));
+    memset(PixelRow + Columns, 0, (WORLD_CHUNK_WIDTH - Columns) * sizeof(uint32));
+    memset(AngleRow + Columns, 0, (WORLD_CHUNK_WIDTH - Columns) * sizeof(uint32));
+  }
+  return true;
+}
+
+// (Read Slot's requested chunk in, unless the other side already claimed it. True if this call read it)
+internal bool32 LoadRequestedWorldChunk(world_streamer* Streamer, world_chunk_slot* Slot){
+  if(AtomicCompareExchangeI32(&Slot->State, WorldChunk_Loading, WorldChunk_Requested) != WorldChunk_Requested){
+    return false;
+  }
+  if(!ReadWorldChunk(Streamer->Map, Slot->Chunk, Slot->Pixels, Slot->Angles)){
+    PlatformOutputDebugString("World chunk read failed: left blank\n");
+  }
+  AtomicAddU64(&Streamer->ChunksLoaded, 1);
+  // (Interlocked: the texels are visible before the state says so)
+  AtomicExchangeI32(&Slot->State, WorldChunk_Ready);
+  return true;
+}
+
+internal void WorldIOThread(void* Data){
+  world_streamer* Streamer = (world_streamer*)Data;
+  for(;;){
+    PlatformWaitSemaphore(Streamer->IOSemaphore);
+    if(Streamer->Quit){ break; }
+    for(int32 i = 0; i < WORLD_RESIDENT_CHUNKS; ++i){
+      LoadRequestedWorldChunk(Streamer, &Streamer->Slots[i]);
+    }
+  }
+}
+
+// (Point the streamer at GameMap's chunks, dropping whatever was resident. The slots and the I/O thread are
+//  created on first use and kept until StopWorldStreamer)
+internal void ResetWorldStreamer(game_map* GameMap){
+  world_streamer* Streamer = &GlobalWorldStreamer;
+  if(!Streamer->IOThread){
+    for(int32 i = 0; i < WORLD_RESIDENT_CHUNKS; ++i){
+      Streamer->Slots[i].Pixels = (uint32*)PlatformAllocateMemory(WorldChunkTexels * sizeof(uint32));
+      Streamer->Slots[i].Angles = (uint32*)PlatformAllocateMemory(WorldChunkTexels * sizeof(uint32));
+    }
+    Streamer->Quit = 0;
+    Streamer->IOSemaphore = PlatformCreateSemaphore(1 << 30);
+    Streamer->IOThread = PlatformCreateThread(WorldIOThread, Streamer);
+  }
+
+  // (Take back unclaimed requests, let reads in flight land: then nothing touches the old source)
+  for(int32 i = 0; i < WORLD_RESIDENT_CHUNKS; ++i){
+    world_chunk_slot* Slot = &Streamer->Slots[i];
+    AtomicCompareExchangeI32(&Slot->State, WorldChunk_Empty, WorldChunk_Requested);
+    while(Slot->State == WorldChunk_Loading){ _mm_pause(); }
+    Slot->State = WorldChunk_Empty;
+    Slot->Chunk = -1;
+    Slot->Uploaded = false;
+  }
+  Streamer->Map = GameMap;
+  Streamer->StreamedXOffset = -1;
+  Streamer->Direction = 1;
+  Streamer->First = Streamer->ViewFirst = 0;
+  Streamer->Last = Streamer->ViewLast = -1;
+}
+
+// (Drain the slots (as ResetWorldStreamer), then join the I/O thread and free the slots: after this nothing
+//  reads the map's chunk source. Safe when never started; the next ResetWorldStreamer starts it again)
+internal void StopWorldStreamer(){
+  world_streamer* Streamer = &GlobalWorldStreamer;
+  if(!Streamer->IOThread){ return; }
+  ResetWorldStreamer(Streamer->Map);
+  Streamer->Quit = 1;
+  PlatformSignalSemaphore(Streamer->IOSemaphore, 1);
+  PlatformJoinThread(Streamer->IOThread);
+  PlatformDestroySemaphore(Streamer->IOSemaphore);
+  for(int32 i = 0; i < WORLD_RESIDENT_CHUNKS; ++i){
+    PlatformFreeMemory(Streamer->Slots[i].Pixels);
+    PlatformFreeMemory(Streamer->Slots[i].Angles);
+    Streamer->Slots[i].Pixels = Streamer->Slots[i].Angles = 0;
+  }
+  Streamer->IOThread = 0;
+  Streamer->IOSemaphore = 0;
+  Streamer->Map = 0;
+}
+
+// (Queue Chunk for its slot unless it is already there. True if a request was made)
+internal bool32 RequestWorldChunk(world_streamer* Streamer, int32 Chunk){
+  world_chunk_slot* Slot = &Streamer->Slots[Chunk % WORLD_RESIDENT_CHUNKS];
+  if(Slot->Chunk == Chunk && Slot->State != WorldChunk_Empty){ return false; }
+
+  // (Evicting: an unclaimed request for the old chunk is taken back, a read in flight is let finish (the
+  //  window only slides this far after the camera has moved on by chunks, long after it was queued))
+  AtomicCompareExchangeI32(&Slot->State, WorldChunk_Empty, WorldChunk_Requested);
+  while(Slot->State == WorldChunk_Loading){ _mm_pause(); }
+  Slot->Chunk = Chunk;
+  Slot->Uploaded = false;
+  AtomicExchangeI32(&Slot->State, WorldChunk_Requested);
+  return true;
+}
+
+// (Sim side, before anything reads the map for the current XOffset (LoadInternalMap, BuildRenderFrame): the
+//  chunks under the view are resident on return, the ones around it queued for the I/O thread. Nothing
+//  happens while XOffset doesn't move)
+internal void StreamWorldChunks(game_map* GameMap){
+  TIMED_BLOCK(StreamChunks);
+  world_streamer* Streamer = &GlobalWorldStreamer;
+  if(GameMap->XOffset == Streamer->StreamedXOffset){ return; }
+  bool32 Loaded = (Streamer->StreamedXOffset >= 0); // (false: a scene's first set, which is waited for by design)
+  if(Loaded){
+    Streamer->Direction = (GameMap->XOffset > Streamer->StreamedXOffset) ? 1 : -1;
+  }
+
+  int32 LastChunk = GameMap->ChunkCount - 1;
+  int32 ViewFirst = GameMap->XOffset / WORLD_CHUNK_WIDTH;
+  int32 ViewLast = (GameMap->XOffset + (int32)InternalWidth - 1) / WORLD_CHUNK_WIDTH;
+  if(ViewLast > LastChunk){ ViewLast = LastChunk; }
+  int32 First = ViewFirst - ((Streamer->Direction < 0) ? WORLD_PREFETCH_CHUNKS : 1);
+  int32 Last = ViewLast + ((Streamer->Direction > 0) ? WORLD_PREFETCH_CHUNKS : 1);
+  if(First < 0){ First = 0; }
+  if(Last > LastChunk){ Last = LastChunk; }
+
+  // (View first, then outwards: the I/O thread takes requests in slot order, which the ring scrambles, but
+  //  the view is checked below anyway)
+  bool32 Requested = false;
+  for(int32 Chunk = ViewFirst; Chunk <= ViewLast; ++Chunk){ Requested |= RequestWorldChunk(Streamer, Chunk); }
+  for(int32 Chunk = First; Chunk <= Last; ++Chunk){ Requested |= RequestWorldChunk(Streamer, Chunk); }
+  if(Requested){ PlatformSignalSemaphore(Streamer->IOSemaphore, 1); }
+
+  // (A view chunk the I/O thread hasn't started on is read right here; one it is reading is waited for)
+  for(int32 Chunk = ViewFirst; Chunk <= ViewLast; ++Chunk){
+    world_chunk_slot* Slot = &Streamer->Slots[Chunk % WORLD_RESIDENT_CHUNKS];
+    if(Slot->State == WorldChunk_Ready){ continue; }
+    if(Loaded){ Streamer->Stalls++; }
+    if(!LoadRequestedWorldChunk(Streamer, Slot)){
+      while(Slot->State != WorldChunk_Ready){ _mm_pause(); }
+    }
+  }
+
+  Streamer->StreamedXOffset = GameMap->XOffset;
+  Streamer->First = First;
+  Streamer->Last = Last;
+  Streamer->ViewFirst = ViewFirst;
+  Streamer->ViewLast = ViewLast;
+}
+
+// (Count columns of map row Row (GL order) from MapX on, out of the resident chunks: StreamWorldChunks must
+//  have made them resident)
+internal void CopyWorldRow(int32 Row, int32 MapX, int32 Count, uint32* Pixels, uint32* Angles){
+  while(Count > 0){
+    int32 Column = MapX % WORLD_CHUNK_WIDTH;
+    int32 Run = (WORLD_CHUNK_WIDTH - Column < Count) ? WORLD_CHUNK_WIDTH - Column : Count;
+    world_chunk_slot* Slot = &GlobalWorldStreamer.Slots[(MapX / WORLD_CHUNK_WIDTH) % WORLD_RESIDENT_CHUNKS];
+    int32 Index = (Row * WORLD_CHUNK_WIDTH) + Column;
+    memcpy(Pixels, &Slot->Pixels[Index], Run * sizeof(uint32));
+    memcpy(Angles, &Slot->Angles[Index], Run * sizeof(uint32));
+    Pixels += Run;
+    Angles += Run;
+    MapX += Run;
+    Count -= Run;
+  }
+}
+
+// (Sim side: the next ready chunk not yet sent to the GPU ring, view chunks first, marked sent. 0 if none)
+internal world_chunk_slot* NextWorldChunkUpload(){
+  world_streamer* Streamer = &GlobalWorldStreamer;
+  for(int32 Pass = 0; Pass < 2; ++Pass){
+    int32 First = Pass ? Streamer->First : Streamer->ViewFirst;
+    int32 Last = Pass ? Streamer->Last : Streamer->ViewLast;
+    for(int32 Chunk = First; Chunk <= Last; ++Chunk){
+      world_chunk_slot* Slot = &Streamer->Slots[Chunk % WORLD_RESIDENT_CHUNKS];
+      if(Slot->Chunk == Chunk && Slot->State == WorldChunk_Ready && !Slot->Uploaded){
+	Slot->Uploaded = true;
+	return Slot;
+      }
+    }
+  }
+  return 0;
+}
+
+// (Sim side: Chunk went out in a render frame that was never drawn: send it again if it is still resident)
+internal void ResendWorldChunk(int32 Chunk){
+  world_chunk_slot* Slot = &GlobalWorldStreamer.Slots[Chunk % WORLD_RESIDENT_CHUNKS];
+  if(Slot->Chunk == Chunk){ Slot->Uploaded = false; }
+}
+
+#define WORLD_H
+#endif